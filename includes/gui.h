@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/13 15:14:40 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/12 20:21:08 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/26 16:02:55 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -132,7 +132,7 @@ typedef struct		s_change_cam
 	KW_Widget		*ed_b[30];
 	KW_Rect			*rects[4];
 	unsigned		weights[4];
-	KW_Widget		*buttons[6];
+	KW_Widget		*buttons[7];
 	char			*names[30];
 	int				show;
 	int				cam_id;
@@ -0,0 +1,92 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native.h                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:20:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NATIVE_H
+# define NATIVE_H
+# include <stddef.h>
+# define WF_GENERATE		1
+# define WF_EXTEND			2
+# define WF_SHADE			3
+# define WF_CONNECT			4
+# define WF_ADAPT			5
+# define DN_INIT			6
+# define DN_PASS			7
+# define DN_FINAL			8
+# define UPSCALE			9
+# define POST_BLUR			10
+# define POST_PACK			11
+# define KERNELS			12
+# define PK_EXTEND			12
+# define PK_CONNECT			13
+# define NATIVE_KERNELS		14
+# define NATIVE_ARGS		32
+# define NATIVE_GEOM		0
+# define NATIVE_SURFACE		1
+# define NATIVE_TXTURE		2
+# define NATIVE_BVH_NODE	3
+# define NATIVE_TRI			4
+# define NATIVE_LIGHT		5
+# define NATIVE_CAM			6
+# define NATIVE_WAVE		7
+# define NATIVE_TYPES		8
+# define NATIVE_BASE		0
+# define NATIVE_SSE42		1
+# define NATIVE_AVX2		2
+
+/*
+** What the host and native_kernels.cc share, the kernel sources built as
+** C++ see none of rt.h. An argument is set the way clSetKernelArg takes
+** it: the array itself for a buffer, the address of the value otherwise.
+** Kernels have the same index on both backends, render_kernel is 0,
+** the packet kernels past KERNELS only exist on the native one. They
+** are built once per instruction set, isa picks the build a launch runs.
+*/
+
+typedef struct		s_native_image
+{
+	const void		*pixels;
+	int				w;
+	int				h;
+}					t_native_image;
+
+typedef struct		s_native_launch
+{
+	int				krl;
+	int				isa;
+	size_t			size[2];
+	void			*arg[NATIVE_ARGS];
+}					t_native_launch;
+
+# ifdef __cplusplus
+
+extern "C" {
+
+# endif
+
+void				native_item(const t_native_launch *launch, size_t item);
+size_t				native_layout(int type);
+int					native_isa(void);
+int					native_lanes(int isa);
+int					native_lanes_base(void);
+int					native_lanes_sse42(void);
+int					native_lanes_avx2(void);
+void				native_packet_base(const t_native_launch *launch);
+void				native_packet_sse42(const t_native_launch *launch);
+void				native_packet_avx2(const t_native_launch *launch);
+
+# ifdef __cplusplus
+
+}
+
+# endif
+
+#endif
@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/10/30 14:49:06 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 18:45:30 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/28 00:53:40 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -17,6 +17,8 @@
 # define SAMPLES 5
 # define CL_SILENCE_DEPRECATION
 # include <sys/types.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
 # include "SDL2/SDL.h"
 # include "SDL_image.h"
 # include "SDL_mixer.h"
@@ -38,6 +40,8 @@
 #  include <CL/cl.h>
 # endif
 # include "gui.h"
+# include "native.h"
+# include <pthread.h>
 # ifndef DEVICE
 #  define DEVICE CL_DEVICE_TYPE_DEFAULT
 # endif
@@ -49,6 +53,45 @@
 
 # define TICKS_PER_FRAME	47
 # define FILE_SIZE			462144
+# define BVH_BINS			12
+# define BVH_LEAF			8
+# define OBJ_CAP_MIN		16
+# define BVH_DEPTH			30
+# define MESH_CHUNK			256
+# define LIGHT_PLANE_AREA	16.0f
+# define BOUNCES			8
+# define MIN_BOUNCES		3
+# define MAX_BOUNCES		32
+# define WAVE_THREADS		65536
+# define DN_PASSES			5
+# define SCALE_MAX			4
+# define SCALE_TARGET		33
+# define SCALE_REST			150
+# define POST_GROUP			64
+# define POST_RADIUS		32
+# define POST_HEAT			1
+# define POST_STEREO		2
+# define POST_SEPIA			4
+# define SEPIA				0x704214
+# define CARTOON			2.0f
+# define WF_WAVE			11
+# define WF_ARG				12
+# define SHADOW_COUNT		2
+# define RAY_COUNT			3
+# define ACTIVE_COUNT		4
+# define PATH_COUNT			6
+# define COUNTERS			38
+# define BENCH_EVENTS		1024
+# define BENCH_LOAD			0
+# define BENCH_RENDER		1
+# define BENCH_READBACK		2
+# define NATIVE_TILE			64
+# define RAYBENCH_RUNS		8
+# define CHECK_W				160
+# define CHECK_H				120
+# define CHECK_SPP			256
+# define CHECK_ERROR			0.02
+# define CHECK_PIXEL			1e-4
 
 typedef enum			e_figure
 {
@@ -58,17 +101,38 @@ typedef enum			e_figure
 	PLANE,
 	TRIANGLE,
 	TORUS,
-	PARABOLOID
+	PARABOLOID,
+	MESH
 }						t_type;
 
+typedef enum			e_tex_format
+{
+	TEX_ARGB8
+}						t_tex_format;
+
 typedef struct			s_txture
 {
+	cl_int				offset;
 	cl_int				width;
 	cl_int				height;
-	cl_int				texture[CL_DEVICE_IMAGE2D_MAX_HEIGHT]\
-	[CL_DEVICE_IMAGE2D_MAX_WIDTH];
+	cl_int				format;
+	cl_int				x;
+	cl_int				y;
 }						t_txture;
 
+typedef struct			s_atlas
+{
+	cl_int				*pixels;
+	size_t				size;
+	size_t				cap;
+	int					img_w;
+	int					img_h;
+	int					img_x;
+	int					max_w;
+	int					max_h;
+	cl_mem				image;
+}						t_atlas;
+
 typedef struct			s_object
 {
 	t_type				type;
@@ -92,8 +156,147 @@ typedef struct			s_object
 	cl_float3			composed_pos;
 	cl_float3			composed_v;
 	cl_int				is_negative;
+	cl_int				mesh_root;
+	cl_float			light_pick;
 }						t_obj;
 
+/*
+** t_obj stays the record the parser and the gui edit. The device gets it
+** split into the geometry the traversal reads and the material shading
+** reads, geom.material indexes the surface table.
+*/
+
+typedef struct			s_geom
+{
+	cl_float3			position;
+	cl_float3			v;
+	cl_float3			vertices[3];
+	cl_float			radius;
+	cl_float			tor_radius;
+	t_type				type;
+	cl_int				is_visible;
+	cl_int				material;
+	cl_int				mesh_root;
+	cl_float			light_pick;
+}						t_geom;
+
+/*
+** Emitters in power order, cdf is the running share of the total power.
+** Each object keeps its own share in light_pick, 0 when it is no light.
+*/
+
+typedef struct			s_light
+{
+	cl_int				id;
+	cl_float			cdf;
+}						t_light;
+
+typedef struct			s_surface
+{
+	cl_float3			color;
+	cl_float3			emission;
+	cl_float3			basis[3];
+	cl_float2			shift;
+	cl_float2			prolapse;
+	cl_float			metalness;
+	cl_float			transparency;
+	cl_float			refraction;
+	cl_int				texture;
+	cl_int				normal;
+}						t_surface;
+
+typedef struct			s_aabb
+{
+	cl_float3			min;
+	cl_float3			max;
+}						t_aabb;
+
+typedef struct			s_bvh_node
+{
+	cl_float3			min;
+	cl_float3			max;
+	cl_int				start;
+	cl_int				count;
+}						t_bvh_node;
+
+typedef struct			s_bvh
+{
+	t_bvh_node			*nodes;
+	cl_int				*index;
+	int					nodes_num;
+	int					nodes_cap;
+	int					unbounded_num;
+}						t_bvh;
+
+typedef struct			s_bvh_bin
+{
+	t_aabb				box;
+	int					count;
+}						t_bvh_bin;
+
+typedef struct			s_bvh_split
+{
+	t_bvh_bin			bins[BVH_BINS];
+	int					axis;
+	int					bin;
+	float				cost;
+	float				cmin;
+	float				scale;
+}						t_bvh_split;
+
+typedef struct			s_bvh_build
+{
+	t_aabb				*bounds;
+	cl_float3			*centroids;
+	t_aabb				cbox;
+	t_bvh				*bvh;
+}						t_bvh_build;
+
+/*
+** Mesh triangles index the shared data array: v are positions, n normals
+** and t uvs, -1 when the face did not reference one.
+*/
+
+typedef struct			s_tri
+{
+	cl_int				v[3];
+	cl_int				n[3];
+	cl_int				t[3];
+}						t_tri;
+
+typedef struct			s_mesh_src
+{
+	char				*name;
+	cl_float			size;
+	cl_float3			position;
+	cl_int				root;
+}						t_mesh_src;
+
+typedef struct			s_mesh
+{
+	cl_float3			*data;
+	int					data_num;
+	int					data_cap;
+	t_tri				*tris;
+	int					tris_num;
+	int					tris_cap;
+	t_bvh				bvh;
+	t_mesh_src			*src;
+	int					src_num;
+}						t_mesh;
+
+typedef struct			s_obj_file
+{
+	char				*p;
+	char				*end;
+	cl_float3			*v[3];
+	int					num[3];
+	int					cap[3];
+	cl_float			size;
+	cl_float3			shift;
+	int					first;
+}						t_obj_file;
+
 typedef struct			s_cam
 {
 	cl_float3			position;
@@ -106,11 +309,270 @@ typedef struct			s_cam
 	cl_int				cartoon;
 	cl_int				sepia;
 	cl_int				stereo;
+	cl_int				denoise;
 	cl_float			motion_blur;
 	cl_float			ambience;
 	cl_int				mask_size;
 }						t_cam;
 
+typedef struct			s_wave
+{
+	t_cam				camera;
+	cl_int				n_objects;
+	cl_int				n_unbounded;
+	cl_int				lightsampling;
+	cl_int				global_texture_id;
+	cl_int				width;
+	cl_int				height;
+	cl_int				tile_x;
+	cl_int				tile_y;
+	cl_int				image_w;
+	cl_int				image_h;
+	cl_int				bounce;
+	cl_int				bounces;
+	cl_int				min_bounces;
+	cl_int				n_lights;
+	cl_int				adaptive;
+	cl_int				views;
+	cl_int				total;
+	cl_int				q_in;
+	cl_uint				seed;
+	cl_uint				sample;
+}						t_wave;
+
+/*
+** Path state has a slot per pixel and view, views is what it is sized
+** for. eye and radiance[1] are the second stereo eye, one float3 while
+** the camera is mono.
+*/
+
+typedef struct			s_wavefront
+{
+	cl_mem				ray_o;
+	cl_mem				ray_d;
+	cl_mem				throughput;
+	cl_mem				hit_t;
+	cl_mem				hit_id;
+	cl_mem				hit_prim;
+	cl_mem				queue[2];
+	cl_mem				counters;
+	cl_mem				radiance[2];
+	cl_mem				sh_point;
+	cl_mem				sh_dir;
+	cl_mem				ray_pdf;
+	cl_mem				moment;
+	cl_mem				spp;
+	cl_mem				active;
+	cl_mem				sh_weight;
+	cl_mem				shadow_queue;
+	cl_mem				cams;
+	cl_mem				eye;
+	int					views;
+	t_wave				wave;
+}						t_wavefront;
+
+typedef struct			s_present
+{
+	cl_mem				out[2];
+	cl_mem				pinned[2];
+	cl_int				*host[2];
+	cl_event			read[2];
+	int					pending[2];
+	int					cur;
+	cl_mem				target;
+}						t_present;
+
+/*
+** Render target apart from the window: the image is cut into square
+** buckets of tile pixels and only the one in flight lives on the device.
+** The last column and row of buckets are cut to the image. While the view
+** changes the whole image is traced at 1/scale of pw by ph, and ow by oh
+** is what comes back to the host.
+*/
+
+typedef struct			s_frame
+{
+	int					w;
+	int					h;
+	int					tile;
+	int					x;
+	int					y;
+	int					tw;
+	int					th;
+	int					scale;
+	int					pw;
+	int					ph;
+	int					ow;
+	int					oh;
+	size_t				cap;
+}						t_frame;
+
+/*
+** Frame time the window aims for in ms while the view changes, the scale
+** it reached carries over to the next move.
+*/
+
+typedef struct			s_scale
+{
+	cl_mem				low;
+	int					target;
+	int					level;
+	int					moving;
+	Uint32				tick;
+}						t_scale;
+
+/*
+** Display time buffers: the two directions of the blur and the look up
+** table of the camera look the table was built for.
+*/
+
+typedef struct			s_post
+{
+	cl_mem				blur[2];
+	cl_mem				lut;
+	int					look;
+}						t_post;
+
+typedef struct			s_denoise
+{
+	cl_mem				albedo;
+	cl_mem				normal;
+	cl_mem				depth;
+	cl_mem				pass[2];
+	int					result;
+}						t_denoise;
+
+/*
+** A device of the context with its own queue, path state and the buffers
+** of its band of rows, swapped into the game while it traces. marks time
+** one launch, done and merged order the copies into the shown buffers.
+*/
+
+typedef struct			s_lane
+{
+	cl_command_queue	queue;
+	t_wavefront			wf;
+	t_denoise			dn;
+	cl_mem				accum;
+	cl_event			mark[2];
+	cl_event			done;
+	cl_event			merged;
+	int					marks;
+	int					row;
+	int					rows;
+	double				rate;
+}						t_lane;
+
+/*
+** The bucket is split in bands of rows across every device of the context.
+** The first lane is the device cl_init picked, it traces the top band
+** straight into the shown buffers. Bands follow the rows per ms each lane
+** managed and were cut for th rows.
+*/
+
+typedef struct			s_split
+{
+	t_lane				*lane;
+	int					num;
+	int					th;
+}						t_split;
+
+/*
+** Work stealing pool of the native backend. A worker owns a range of the
+** tiles of a launch and takes them from the front, once it ran dry it
+** takes from the back of the others. gen counts the launches, busy the
+** workers still in the one in flight.
+*/
+
+typedef struct			s_deque
+{
+	pthread_mutex_t		lock;
+	size_t				lo;
+	size_t				hi;
+}						t_deque;
+
+typedef struct			s_worker
+{
+	pthread_t			thread;
+	struct s_pool		*pool;
+	int					id;
+	t_deque				deque;
+}						t_worker;
+
+typedef struct			s_pool
+{
+	t_worker			*worker;
+	int					num;
+	int					gen;
+	int					busy;
+	pthread_mutex_t		lock;
+	pthread_cond_t		start;
+	pthread_cond_t		done;
+	t_native_launch		*launch;
+	size_t				items;
+}						t_pool;
+
+/*
+** Host side of the native backend: t_wavefront and the buffers of the
+** passes after it as plain arrays, with the arguments of every kernel
+** set once the way they are on a device.
+*/
+
+typedef struct			s_native
+{
+	t_pool				pool;
+	t_native_launch		krl[NATIVE_KERNELS];
+	t_native_image		atlas;
+	t_wave				wave;
+	t_cam				cams[2];
+	int					views;
+	int					isa;
+	int					packet;
+	cl_float3			*ray_o;
+	cl_float3			*ray_d;
+	cl_float3			*throughput;
+	cl_float3			*sh_point;
+	cl_float3			*sh_dir;
+	cl_float3			*sh_weight;
+	cl_float			*hit_t;
+	cl_float			*ray_pdf;
+	cl_int				*hit_id;
+	cl_int				*hit_prim;
+	cl_int				*queue[2];
+	cl_int				*shadow_queue;
+	cl_int				counters[COUNTERS];
+	cl_float3			*radiance[2];
+	cl_float3			*eye;
+	cl_float3			*accum;
+	cl_float			*moment;
+	cl_int				*spp;
+	cl_int				*active;
+	cl_float3			*albedo;
+	cl_float3			*normal;
+	cl_float			*depth;
+	cl_float4			*pass[2];
+	cl_int				lut[256];
+	cl_int				*out;
+}						t_native;
+
+typedef struct			s_bench
+{
+	cl_event			events[BENCH_EVENTS];
+	int					event_krl[BENCH_EVENTS];
+	int					events_num;
+	cl_ulong			kernel_ns[KERNELS];
+	cl_uint				launches[KERNELS];
+	cl_ulong			rays;
+	cl_ulong			paths[MAX_BOUNCES];
+	double				host_ms[3];
+	int					spp;
+	char				*out;
+	char				**scenes;
+	int					scenes_num;
+	int					scenes_cap;
+	FILE				*fp;
+}						t_bench;
+
 typedef enum			e_camera_direction
 {
 	left,
@@ -130,11 +592,15 @@ typedef struct			s_gpu
 	cl_kernel			kernel;
 	cl_uint				num_platforms;
 	cl_int				err;
-	cl_ulong			*random;
 	char				*kernel_source;
 	cl_float3			*vec_temp;
-	cl_float3			*vec_temp1;
 	t_obj				*objects;
+	t_geom				*geoms;
+	t_surface			*surfaces;
+	size_t				pack_cap;
+	t_light				*lights;
+	int					lights_num;
+	size_t				lights_cap;
 	cl_mem				cl_cpu_spheres;
 	cl_mem				cl_buffer_out;
 	cl_mem				cl_cpu_vectemp;
@@ -165,6 +631,9 @@ typedef struct			s_keys
 	int					x;
 	int					space;
 	int					r;
+	int					heat;
+	int					adaptive;
+	int					nee;
 	Sint32				xrel;
 	Sint32				yrel;
 	int					show_gui;
@@ -177,6 +646,11 @@ typedef struct			s_game
 	SDL_Event			ev;
 	t_sdl				sdl;
 	size_t				obj_quantity;
+	size_t				obj_cap;
+	size_t				obj_dev_cap;
+	int					dirty_first;
+	int					dirty_last;
+	int					layout_dirty;
 	int					cam_quantity;
 	t_gpu				gpu;
 	t_txture			*textures;
@@ -185,6 +659,7 @@ typedef struct			s_game
 	char				**normal_list;
 	int					normals_num;
 	t_txture			*normals;
+	t_atlas				atlas;
 	t_cl_info			*cl_info;
 	t_cl_krl			*kernels;
 	int					cam_num;
@@ -194,14 +669,27 @@ typedef struct			s_game
 	t_mouse_pos			mouse;
 	cl_int				global_tex_id;
 	SDL_Surface			*blured;
-	cl_float3			*vertices_list;
-	int					vertices_num;
 	int					gui_mod;
 	int					server;
 	int					samples_to_do;
 	char				*music;
 	cl_float			*mask;
 	int					mask_size;
+	t_bvh				bvh;
+	t_mesh				mesh;
+	t_wavefront			wf;
+	cl_uint				seed;
+	int					min_bounces;
+	int					max_bounces;
+	int					headless;
+	t_bench				*bench;
+	t_present			present;
+	t_denoise			dn;
+	t_frame				frame;
+	t_scale				scale;
+	t_post				post;
+	t_split				split;
+	t_native			native;
 }						t_game;
 
 typedef struct			s_filter
@@ -210,6 +698,7 @@ typedef struct			s_filter
 	int					cartoon;
 	int					sepia;
 	int					stereo;
+	int					denoise;
 	float				motion_blur;
 }						t_filter;
 
@@ -248,6 +737,7 @@ typedef struct			s_json
 	cJSON				*cartoon;
 	cJSON				*sepia;
 	cJSON				*stereo;
+	cJSON				*denoise;
 	cJSON				*motion_blur;
 	cJSON				*ambience;
 	cJSON				*global_texture;
@@ -259,6 +749,50 @@ typedef struct			s_json
 	cJSON				*music;
 }						t_json;
 
+typedef struct			s_headless
+{
+	char				*scene;
+	char				*out;
+	int					spp;
+	int					denoise;
+	int					w;
+	int					h;
+	int					tile;
+	int					exr;
+	int					cpu;
+	int					threads;
+}						t_headless;
+
+/*
+** One scene's primary and shadow rays traced again and again, [0] by the
+** single ray kernels and [1] by the packet ones.
+*/
+
+typedef struct			s_raybench
+{
+	char				*scene;
+	int					threads;
+	int					runs;
+	int					rays[2];
+	double				ms[2][2];
+	int					mismatch[2];
+}						t_raybench;
+
+/*
+** Renders of a scene that have to agree. mean holds the mean radiance of
+** two of them, worst the largest difference of a pixel of the denoised
+** and of the raw image, over the frame and next to the seams of a split.
+*/
+
+typedef struct			s_check
+{
+	char				*scene;
+	int					spp;
+	int					threads;
+	double				mean[2][3];
+	double				worst[2][2];
+}						t_check;
+
 typedef struct			s_gui
 {
 	KW_Widget			*destroy[MAX_OBJ * 5];
@@ -292,7 +826,99 @@ void					ft_run_gpu(t_gpu *gpu);
 cl_float3				create_cfloat3 (float x, float y, float z);
 cl_float3				cl_scalar_mul(cl_float3 vector, double scalar);
 cl_float3				cl_add(cl_float3 v1, cl_float3 v2);
-void					get_texture(char *name, t_txture *texture, char *path);
+void					get_texture(t_game *game, char *name,\
+t_txture *texture, char *path);
+cl_int					atlas_push(t_atlas *atlas, cl_int *pixels,\
+size_t count);
+void					textures_init_args(t_game *game);
+void					atlas_pack(t_game *game);
+void					atlas_limits(t_game *game);
+void					atlas_upload(t_game *game);
+void					atlas_blit(t_atlas *atlas, t_txture *tex, int num,\
+cl_int *img);
+void					wavefront_init(t_game *game);
+void					wavefront_state(t_game *game);
+void					wavefront_views(t_game *game, int views);
+void					wavefront_bind(t_game *game);
+void					wavefront_bind_scene(t_game *game);
+void					wavefront_arg(t_game *game, int krl, int idx,\
+cl_mem *mem);
+void					wavefront_render(t_game *game);
+void					wavefront_setup(t_game *game, t_wave *wave,\
+t_cam *cams);
+cl_mem					wavefront_buffer(t_game *game, size_t size,\
+void *host);
+void					wavefront_kernel(t_game *game, int idx, char *name,\
+int nargs);
+void					denoise_init(t_game *game);
+void					denoise_run(t_game *game);
+void					denoise_read(t_game *game, cl_float3 *pixels);
+void					present_init(t_game *game);
+void					present_bind(t_game *game);
+void					present_read(t_game *game);
+void					present_wait(t_game *game, int slot);
+void					present_flush(t_game *game);
+void					scale_init(t_game *game);
+void					scale_upscale(t_game *game);
+void					scale_motion(t_game *game);
+void					scale_rest(t_game *game);
+void					post_init(t_game *game);
+void					post_run(t_game *game);
+void					post_lut(cl_int *table, cl_int look);
+void					split_init(t_game *game);
+void					split_trace(t_game *game, t_cl_krl *kernel);
+void					split_merge(t_game *game);
+void					lane_swap(t_game *game, t_lane *lane);
+void					lane_begin(t_game *game, t_lane *lane);
+void					lane_end(t_game *game, t_lane *lane);
+void					lane_time(t_lane *lane, int wait);
+int						headless_main(int argc, char **argv);
+void					headless_setup(t_game *game, t_gui *gui, int cpu);
+void					headless_tile(t_game *game, t_headless *opt,\
+cl_float3 *image);
+void					headless_usage(void);
+void					headless_args(t_headless *opt, int argc, char **argv);
+void					pool_init(t_pool *pool, int num);
+void					pool_run(t_pool *pool, t_native_launch *launch);
+void					native_init(t_game *game, char *scene, int threads);
+void					native_state(t_game *game);
+void					native_bind(t_game *game);
+void					native_exec(t_game *game, int krl, size_t w, size_t h);
+void					native_rays(t_game *game, int krl, int rays);
+void					native_trace(t_game *game);
+void					native_tile(t_game *game, int spp, cl_float3 *image);
+void					frame_init(t_game *game, int w, int h, int tile);
+int						frame_tile(t_game *game, int i);
+void					frame_scale(t_game *game, int scale);
+void					frame_present(t_game *game, cl_int *tile);
+void					frame_store(t_game *game, cl_float3 *image,\
+cl_float3 *tile);
+int						bench_main(int argc, char **argv);
+void					bench_push(t_bench *bench, char *scene);
+void					bench_scenes(t_bench *bench);
+int						raybench_main(int argc, char **argv);
+int						check_main(int argc, char **argv);
+int						check_report(t_check *check, char *first,\
+char *second);
+int						check_worst(t_check *check);
+int						mischeck_main(t_check *check);
+int						splitcheck_main(t_check *check);
+void					raybench_run(t_game *game, t_raybench *rb);
+void					bench_queue(t_game *game);
+void					krl_exec(t_game *game, int krl, cl_uint dim,\
+size_t *global);
+void					krl_exec_local(t_game *game, int krl, size_t *global,\
+size_t *local);
+void					bench_collect(t_game *game);
+void					bench_rays(t_game *game);
+void					bench_reset(t_game *game, t_bench *bench);
+void					bench_paths(t_game *game, t_bench *bench);
+double					bench_ms(Uint64 from);
+void					bench_open(t_game *game, t_bench *bench);
+void					bench_report(t_game *game, t_bench *bench,\
+char *scene, int first);
+void					bench_close(t_bench *bench);
+void					save_exr(char *path, cl_float3 *pixels, int w, int h);
 void					read_scene(char *argv, t_game *game);
 t_cam					*add_cam(cl_float3 position,\
 cl_float3 direction, cl_float3 normal);
@@ -302,7 +928,7 @@ cl_float3				rotate(cl_float3 axis, cl_float3 vector, float angle);
 cl_float3				cross(cl_float3 one, cl_float3 two);
 cl_float3				vector_diff(cl_float3 one, cl_float3 two);
 cl_float3				normalize(cl_float3 vector);
-void					reconfigure_camera(t_cam *camera);
+void					reconfigure_camera(t_game *game, t_cam *camera);
 void					rotate_vertical(t_cam *camera, float angle);
 void					rotate_horizontal(t_cam *camera, float angle);
 int						ft_input_keys(t_game *game);
@@ -310,7 +936,6 @@ void					key_check(t_game *game);
 void					camera_reposition(t_game *game, t_gui *gui);
 void					set_const(t_game *game, t_gui *gui);
 void					opencl(t_game *game, char *argv);
-cl_ulong				*get_random(cl_ulong *random);
 void					main_render(t_game *game, t_gui *gui);
 void					free_opencl(t_game *game);
 void					terminate(char *s);
@@ -325,6 +950,7 @@ void					main_screen(t_gui *gui, t_game *game);
 void					obj_select(t_gui *gui, t_obj *objs, int num);
 void					pos_check(t_game *game, t_gui *gui);
 void					opencl_init(t_game *game);
+char					*cl_build_flags(t_game *game);
 void					check_file(t_game *game);
 cl_float2				create_cfloat2 (float x, float y);
 cl_float3				parse_vec3(cJSON *vec, int flag);
@@ -444,9 +1070,21 @@ void					del_cam(t_cam *cam, t_game *game);
 void					add_cam_button(t_gui *gui);
 void					ddd_name(KW_Widget *widget, t_cam *cam);
 void					ddd(KW_Widget *widget, int b);
+void					cam_denoise(t_gui *gui, t_cam *cam);
 void					push_tex(t_game *game, char *res);
 void					obj3d_parse(const cJSON *object, t_game *game,
 t_json *parse);
+void					obj_skip(t_obj_file *f);
+int						obj_eol(t_obj_file *f);
+float					obj_float(t_obj_file *f);
+int						obj_int(t_obj_file *f, int *value);
+void					obj_face(t_obj_file *f, t_game *game);
+void					*mesh_grow(void *ptr, int *cap, int num, size_t size);
+void					mesh_reset(t_game *game);
+void					mesh_append(t_game *game, t_obj_file *f);
+void					mesh_build(t_game *game, t_obj_file *f, char *name);
+void					mesh_init_args(t_game *game);
+void					mesh_print(t_game *game, t_obj *obj, FILE *fp);
 cl_float3				triangle_norm(cl_float3 *vertices);
 void					push_normal(t_game *game, char *res);
 void					check_ed_box_focus(t_game *game, t_gui *gui,
@@ -483,6 +1121,8 @@ void					read_scene(char *argv, t_game *game);
 void					check_object(const cJSON *object, t_game *game,\
 t_json parse, int id);
 void					check_scene(t_json parse, t_game *game);
+void					check_bounces(cJSON *scene, t_game *game);
+void					check_frame_time(cJSON *scene, t_game *game);
 void					check_cam(t_json parse, t_game *game, t_filter *filter);
 cl_float3				get_composed_pos(cJSON *composed_pos);
 cl_float3				get_composed_v(cJSON *composed_v);
@@ -496,17 +1136,44 @@ void					parse_rest(const cJSON *object, t_obj *obj,\
 t_json *parse);
 void					parse_triangle_vert(const cJSON *object,\
 t_obj *obj, t_json *parse);
-void					prepare_data(char ***data, char *line);
 char					*make_string(char *name, int smpls, int fd);
 void					scene_click(KW_Widget *widget, int b);
 void					net_render(KW_Widget *widget, int b);
 float					*create_blur_mask(float sigma, int *mask_size_pointer);
 void					net_return(t_game *game, t_gui *gui);
 void					ft_run_kernel(t_game *game, t_cl_krl *kernel);
+void					ft_display(t_game *game);
 void					client_side_free(t_gui *gui, char **buff, FILE *fp);
 void					new_mask_push(t_gui *gui, t_cam *cam, int *i);
 void					scroll_box_free(t_gui *gui, KW_Widget *frame);
 void					set_default_triangle(t_obj *obj);
 void					*malloc_exit(size_t len);
+t_aabb					aabb_empty(void);
+void					aabb_grow(t_aabb *box, cl_float3 point);
+void					aabb_merge(t_aabb *box, t_aabb *other);
+float					aabb_area(t_aabb *box);
+int						object_bounds(t_obj *obj, t_aabb *box);
+int						bvh_bin_of(t_bvh_split *split, float centroid);
+void					bvh_find_split(t_bvh_build *b, t_bvh_split *best,\
+int first, int count);
+int						bvh_partition(t_bvh_build *b, t_bvh_split *split,\
+int first, int count);
+void					bvh_subdivide(t_bvh_build *b, int first, int count,\
+int depth);
+void					build_bvh(t_game *game);
+void					bvh_upload(t_game *game);
+void					bvh_refit(t_game *game);
+void					obj_dirty(t_game *game, int first, int last);
+void					obj_touch(t_game *game, t_obj *obj);
+void					obj_flush(t_game *game);
+void					obj_buffer_init(t_game *game);
+void					obj_pack(t_game *game, int first, int last);
+void					lights_build(t_game *game);
+void					lights_write(t_game *game);
+void					lights_init_args(t_game *game);
+void					obj_pack_write(t_game *game, int first, int count);
+void					obj_mem_grow(t_game *game, int arg, size_t size,\
+void *host);
+void					bvh_init_args(t_game *game);
 
 #endif
@@ -0,0 +1,157 @@
+#define BVH_STACK 32
+
+/* slab test, returns the entry distance or INFINITY when the box is missed
+ * or lies behind the closest hit found so far */
+static float	bvh_box(__global t_bvh_node *node, t_ray *ray, float3 inv_dir)
+{
+	float3	t0 = (node->min - ray->origin) * inv_dir;
+	float3	t1 = (node->max - ray->origin) * inv_dir;
+	float3	tmin = fmin(t0, t1);
+	float3	tmax = fmax(t0, t1);
+	float	tnear = fmax(fmax(tmin.x, tmin.y), fmax(tmin.z, 0.f));
+	float	tfar = fmin(fmin(tmax.x, tmax.y), tmax.z);
+
+	return (tnear <= tfar && tnear < ray->t ? tnear : INFINITY);
+}
+
+static void		intersect_candidate(t_scene *scene, t_intersection *intersection,
+				t_ray *ray, int i)
+{
+	float	hitdistance;
+	int		prim = -1;
+
+	if (!scene->objects[i].is_visible)
+		return ;
+	if (scene->objects[i].type == MESH)
+		hitdistance = mesh_intersect(scene, &scene->objects[i], ray, &prim);
+	else
+		hitdistance = intersect_object(&scene->objects[i], ray);
+	/* keep track of the closest intersection and hitobject found so far */
+	if (hitdistance != 0.0f && hitdistance < ray->t)
+	{
+		ray->t = hitdistance;
+		intersection->object_id = i;
+		intersection->prim = prim;
+	}
+}
+
+/* pops the next pending subtree that can still beat the closest hit */
+static int		bvh_pop(int *stack, float *dist, int *top, float t)
+{
+	while (*top > 0)
+	{
+		(*top)--;
+		if (dist[*top] < t)
+			return (stack[*top]);
+	}
+	return (-1);
+}
+
+/* interior nodes have count < 0, their left child follows them in the
+ * array and start holds the right one; leaves index scene->bvh_index */
+static void		bvh_intersect(t_scene *scene, t_intersection *intersection,
+				t_ray *ray)
+{
+	int		stack[BVH_STACK];
+	float	dist[BVH_STACK];
+	int		top = 0;
+	int		node = 0;
+	float3	inv_dir = 1.f / ray->dir;
+
+	if (bvh_box(scene->bvh, ray, inv_dir) == INFINITY)
+		return ;
+	while (node >= 0)
+	{
+		__global t_bvh_node *cur = &scene->bvh[node];
+		if (cur->count < 0)
+		{
+			int		first = node + 1;
+			int		second = cur->start;
+			float	t_first = bvh_box(&scene->bvh[first], ray, inv_dir);
+			float	t_second = bvh_box(&scene->bvh[second], ray, inv_dir);
+			if (t_second < t_first)
+			{
+				first = cur->start;
+				second = node + 1;
+				float swap = t_first;
+				t_first = t_second;
+				t_second = swap;
+			}
+			if (t_first < INFINITY)
+			{
+				if (t_second < INFINITY && top < BVH_STACK)
+				{
+					stack[top] = second;
+					dist[top++] = t_second;
+				}
+				node = first;
+				continue ;
+			}
+		}
+		else
+			for (int i = cur->start; i < cur->start + cur->count; i++)
+				intersect_candidate(scene, intersection, ray, scene->bvh_index[i]);
+		node = bvh_pop(stack, dist, &top, ray->t);
+	}
+}
+
+/* any blocker in front of ray->t answers the query, there is no closest
+ * hit to keep so the objects skip the bookkeeping intersect_candidate does */
+static bool		occlude_candidate(t_scene *scene, t_ray *ray, int i)
+{
+	float	d;
+
+	if (!scene->objects[i].is_visible)
+		return (false);
+	if (scene->objects[i].type == MESH)
+		return (mesh_intersect(scene, &scene->objects[i], ray, 0) != 0.f);
+	d = intersect_object(&scene->objects[i], ray);
+	return (d != 0.f && d < ray->t);
+}
+
+/* the closest hit traversal without child ordering, it stops at the first
+ * leaf object that blocks the ray */
+static bool		bvh_occluded(t_scene *scene, t_ray *ray)
+{
+	int		stack[BVH_STACK];
+	int		top = 0;
+	int		node = 0;
+	float3	inv_dir = 1.f / ray->dir;
+
+	if (bvh_box(scene->bvh, ray, inv_dir) == INFINITY)
+		return (false);
+	while (node >= 0)
+	{
+		__global t_bvh_node *cur = &scene->bvh[node];
+		if (cur->count < 0)
+		{
+			bool	left = bvh_box(&scene->bvh[node + 1], ray, inv_dir) < INFINITY;
+			bool	right = bvh_box(&scene->bvh[cur->start], ray, inv_dir) < INFINITY;
+			if (left && right && top < BVH_STACK)
+				stack[top++] = cur->start;
+			if (left || right)
+			{
+				node = left ? node + 1 : cur->start;
+				continue ;
+			}
+		}
+		else
+			for (int i = cur->start; i < cur->start + cur->count; i++)
+				if (occlude_candidate(scene, ray, scene->bvh_index[i]))
+					return (true);
+		node = top > 0 ? stack[--top] : -1;
+	}
+	return (false);
+}
+
+/* shadow query: true when anything lies on the ray closer than tmax. The
+ * caller ends the ray just short of the light it sampled, so the emitter
+ * it aims at is never tested against itself */
+static bool		occluded(t_scene *scene, t_ray *ray, float tmax)
+{
+	ray->t = tmax;
+	for (int i = 0; i < scene->n_unbounded; i++)
+		if (occlude_candidate(scene, ray, scene->bvh_index[i]))
+			return (true);
+	return (bvh_occluded(scene, ray));
+}
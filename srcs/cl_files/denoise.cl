@@ -0,0 +1,111 @@
+/* edge-avoiding a-trous wavelet filter in the spirit of SVGF. It only
+ * touches the displayed frame: vect_temp keeps accumulating the raw
+ * samples. Color is divided by the first hit albedo so textures survive,
+ * every pass blurs a 5x5 b3-spline footprint spread by its step and stops
+ * at normal, depth and luminance edges. The luminance bound follows the
+ * standard deviation of the pixel, which is filtered along with it. */
+
+#define DN_SIGMA_L 4.f
+#define DN_SIGMA_N 128.f
+#define DN_SIGMA_Z 0.01f
+#define DN_ALBEDO 0.01f
+#define DN_HISTORY 4
+
+static float3	denoise_albedo(float3 albedo)
+{
+	return (fmax(albedo, (float3)(DN_ALBEDO)));
+}
+
+/* variance of the mean from the batch moments adapt keeps, a spatial
+ * estimate stands in while the pixel has too few batches for it */
+static float	denoise_variance(__global float3 *vect_temp, __global float3 *albedo,
+				float moment, int spp, int samples, int2 pos, int2 size)
+{
+	float	batches = abs(spp) / SAMPLES;
+	float	mean;
+	float	m2 = 0.f;
+	float	m1 = 0.f;
+	float	n = 0.f;
+	int		q;
+
+	if (batches >= DN_HISTORY)
+	{
+		q = pos.x + pos.y * size.x;
+		mean = luminance(vect_temp[q]) / samples;
+		m1 = luminance(denoise_albedo(albedo[q]));
+		return (fmax(moment / batches - mean * mean, 0.f) / batches / (m1 * m1));
+	}
+	for (int y = max(pos.y - 1, 0); y <= min(pos.y + 1, size.y - 1); y++)
+		for (int x = max(pos.x - 1, 0); x <= min(pos.x + 1, size.x - 1); x++)
+		{
+			q = x + y * size.x;
+			mean = luminance(vect_temp[q] / denoise_albedo(albedo[q])) / samples;
+			m1 += mean;
+			m2 += mean * mean;
+			n += 1.f;
+		}
+	m1 /= n;
+	return (fmax(m2 / n - m1 * m1, 0.f));
+}
+
+/* demodulated color in xyz and its variance in w */
+__kernel void	denoise_init_kernel(__global float3 *vect_temp, __global float3 *albedo,
+				__global float *moment, __global int *spp, int samples,
+				__global float4 *out)
+{
+	int2	pos = (int2)(get_global_id(0), get_global_id(1));
+	int2	size = (int2)(get_global_size(0), get_global_size(1));
+	int		p = pos.x + pos.y * size.x;
+
+	out[p].xyz = vect_temp[p] / samples / denoise_albedo(albedo[p]);
+	out[p].w = denoise_variance(vect_temp, albedo, moment[p], spp[p], samples, pos, size);
+}
+
+/* one level of the wavelet, step doubles from pass to pass. Pixels that
+ * saw the sky have no normal and are never mixed with anything */
+__kernel void	denoise_kernel(__global float4 *in, __global float4 *out,
+				__global float3 *normal, __global float *depth, int step)
+{
+	const float	h[3] = {3.f / 8.f, 1.f / 4.f, 1.f / 16.f};
+	int2		pos = (int2)(get_global_id(0), get_global_id(1));
+	int2		size = (int2)(get_global_size(0), get_global_size(1));
+	int			p = pos.x + pos.y * size.x;
+	float4		c = in[p];
+	float		bound = DN_SIGMA_L * sqrt(c.w) + 1e-4f;
+	float4		sum = (float4)(c.xyz, c.w * h[0] * h[0]) * h[0] * h[0];
+	float		wsum = h[0] * h[0];
+	float4		cq;
+	float		w;
+	int2		q;
+
+	if (length(normal[p]) == 0.f)
+	{
+		out[p] = c;
+		return ;
+	}
+	for (int dy = -2; dy <= 2; dy++)
+		for (int dx = -2; dx <= 2; dx++)
+		{
+			q = pos + (int2)(dx, dy) * step;
+			if ((!dx && !dy) || q.x < 0 || q.y < 0 || q.x >= size.x || q.y >= size.y)
+				continue ;
+			cq = in[q.x + q.y * size.x];
+			w = h[abs(dx)] * h[abs(dy)]
+				* pow(fmax(dot(normal[p], normal[q.x + q.y * size.x]), 0.f), DN_SIGMA_N)
+				* exp(-fabs(depth[p] - depth[q.x + q.y * size.x])
+					/ (DN_SIGMA_Z * depth[p] * step * length((float2)(dx, dy))))
+				* exp(-fabs(luminance(c.xyz) - luminance(cq.xyz)) / bound);
+			sum += (float4)(cq.xyz, cq.w * w) * w;
+			wsum += w;
+		}
+	out[p] = (float4)(sum.xyz / wsum, sum.w / (wsum * wsum));
+}
+
+/* puts the albedo back, the linear result feeds post.cl and the exr
+ * output */
+__kernel void	denoise_final_kernel(__global float4 *in, __global float3 *albedo)
+{
+	int		p = get_global_id(0) + get_global_id(1) * get_global_size(0);
+
+	in[p].xyz = in[p].xyz * denoise_albedo(albedo[p]);
+}
@@ -20,7 +20,7 @@ static float ft_solve(float a, float b, float c)
 	return(0.f);
 }
 
-static float intersect_cone(__global t_obj* cone, const t_ray *  ray)
+static float intersect_cone(__global t_geom *cone, const t_ray *  ray)
 {
 	float3	x = ray->origin - cone->position;
 	float	a = dot(ray->dir, cone->v);
@@ -33,7 +33,7 @@ static float intersect_cone(__global t_obj* cone, const t_ray *  ray)
 	return (ft_solve(a, b, c));
 }
 
-static float intersect_sphere(__global t_obj *sphere,  t_ray *  ray)
+static float intersect_sphere(__global t_geom *sphere,  t_ray *  ray)
 {
 	float3 rayToCenter = ray->origin - sphere->position;
     float a = 1;
@@ -42,7 +42,7 @@ static float intersect_sphere(__global t_obj *sphere,  t_ray *  ray)
 	return (ft_solve(a, b, c));
 }
 
-static float		intersect_plane(__global t_obj *plane, const t_ray *ray)
+static float		intersect_plane(__global t_geom *plane, const t_ray *ray)
 {
 	float	a;
 	float	b;
@@ -54,7 +54,7 @@ static float		intersect_plane(__global t_obj *plane, const t_ray *ray)
 }
 
 
-static float		intersect_cylinder(__global t_obj *cylinder, const t_ray *  ray)
+static float		intersect_cylinder(__global t_geom *cylinder, const t_ray *  ray)
 {
 	float3	x = ray->origin - cylinder->position;
 	float	a = dot(ray->dir, cylinder->v);
@@ -66,7 +66,7 @@ static float		intersect_cylinder(__global t_obj *cylinder, const t_ray *  ray)
 	return (ft_solve(a, b, c));
 }
 
-static int inside_triangle(__global t_obj *triangle, float3 collision)
+static int inside_triangle(__global t_geom *triangle, float3 collision)
 {
 	if (dot(triangle->v, cross(triangle->vertices[1] - triangle->vertices[0], collision - triangle->vertices[0])) > 0 &&
 		dot(triangle->v, cross(triangle->vertices[2] - triangle->vertices[1], collision - triangle->vertices[1])) > 0 &&
@@ -75,7 +75,7 @@ static int inside_triangle(__global t_obj *triangle, float3 collision)
 	return(0);
 }
 
-static float		intersect_triangle(__global t_obj *triangle,  t_ray *  ray)
+static float		intersect_triangle(__global t_geom *triangle,  t_ray *  ray)
 {
 	float	a;
 	float	b;
@@ -90,7 +90,7 @@ static float		intersect_triangle(__global t_obj *triangle,  t_ray *  ray)
 	return (b < EPSILON) ? 0 : b;
 }
 
-static float	intersect_parabol(__global t_obj *parabol, t_ray *ray)
+static float	intersect_parabol(__global t_geom *parabol, t_ray *ray)
 {
 	float3 pos =  ray->origin - parabol->position;
 	float3 dir =  ray->dir;
@@ -102,143 +102,155 @@ static float	intersect_parabol(__global t_obj *parabol, t_ray *ray)
 	return (ft_solve(a, b, c));
 }
 
-void positive_discriminant(double Q, __double2 koefs, double *solve, double b)
+#define TORUS_STEPS 96
+#define TORUS_POLISH 8
+
+/* exact distance to the torus surface, p is relative to its centre */
+static float	torus_sdf(float3 p, float3 axis, float big, float small)
 {
-	double alpha, betha, ntmp;
+	float	h = dot(p, axis);
+	float	q = length(p - h * axis) - big;
 
-	ntmp = -koefs[1] / 3.f;
-		alpha = cbrt(-koefs[0] / 2.f + sqrt(Q));
-		betha = -koefs[1] / (3.f * alpha);
-		*solve = alpha + betha - b;
+	return (sqrt(q * q + h * h) - small);
 }
 
-void negative_discriminant(double Q, __double2 koefs, double *solve, double b)
+/* clips the ray to the slab |h| <= small around the torus plane and to its
+ * bounding sphere, and to the closest hit found so far */
+static int		torus_span(float3 o, t_ray *ray, float3 axis, float big,
+				float small, float2 *span)
 {
-	double cosphi, tmp, ntmp, phi;
+	float	b = dot(o, ray->dir);
+	float	c = dot(o, o) - (big + small) * (big + small);
+	float	disc = b * b - c;
+	float	h0 = dot(o, axis);
+	float	hd = dot(ray->dir, axis);
 
-	tmp = -3.f / koefs.y;
-	ntmp = -koefs.y / 3.f;
-	cosphi = -koefs.x * 0.5f * sqrt(tmp * tmp * tmp);
-	phi = acos(cosphi);
-	*solve = 2.f * sqrt(ntmp) * cos(phi / 3.f) - b;
+	if (disc < 0.f)
+		return (0);
+	disc = sqrt(disc);
+	span->x = fmax(-b - disc, 0.f);
+	span->y = fmin(-b + disc, ray->t);
+	if (fabs(hd) > 1e-8f)
+	{
+		span->x = fmax(span->x, fmin((-small - h0) / hd, (small - h0) / hd));
+		span->y = fmin(span->y, fmax((-small - h0) / hd, (small - h0) / hd));
+	}
+	else if (fabs(h0) > small)
+		return (0);
+	return (span->x <= span->y);
 }
 
+/* derivative of torus_sdf along dir at p, 0 on the core circle and the
+ * axis where the distance has no gradient */
+static float	torus_slope(float3 p, float3 dir, float3 axis, float big)
+{
+	float	h = dot(p, axis);
+	float3	r = p - h * axis;
+	float	lr = length(r);
+	float	q = lr - big;
+	float	n = sqrt(q * q + h * h);
+
+	if (lr < 1e-12f || n < 1e-12f)
+		return (0.f);
+	return (dot(r * (q / lr) + axis * h, dir) / n);
+}
 
-void fourth_degree_equation_solver(__float4 koefs, __float2 *solve)
+/* newton steps on the distance from where the march stopped, b.x is the
+ * last point outside and b.y the stop. When b.y is past the surface the
+ * root stays bracketed and a step leaving the bracket bisects it instead,
+ * otherwise such a step means the ray only grazes the surface and ends
+ * the search. The root counts when it lies on the surface and inside the
+ * span, anything else is a miss */
+static float	torus_hit(__global t_geom *torus, float3 o, t_ray *ray,
+				float2 b, float side, float far)
 {
-	__double3 ferrari_koefs, cubic_resol_koefs;
-	__double2 cubic_two_params_koefs;
-	double a2, a3, a4, p2, b2, Q, cubic_solve;
-	t_quad q;
-
-	a2 = koefs[3] * koefs[3];
-	a3 = a2 * koefs[3];
-	a4 = a2 * a2;
-	//y4+py2+qy+r=0
-	ferrari_koefs[2] = koefs[2] - 0.375f * a2;
-	ferrari_koefs[1] = 0.125f * a3 - 0.5f * koefs[2] * koefs[3] + koefs[1];
-	ferrari_koefs[0] = (-0.01171875f) * a4 + 0.0625f * koefs[2] * a2 - 0.25f * koefs[1] * koefs[3] + koefs[0];
-	if (ferrari_koefs[1] * ferrari_koefs[1] < 1e-4)
+	float3	axis = normalize(torus->v);
+	float	eps = 1e-4f * (torus->radius + torus->tor_radius);
+	float	t = b.y;
+	float	d = side * torus_sdf(o + ray->dir * t, axis, torus->radius,
+		torus->tor_radius);
+	int		inside = d < 0.f;
+	float	n;
+
+	b.y = inside ? b.y : b.y + 16.f * eps;
+	for (int i = 0; i < TORUS_POLISH && fabs(d) >= 1e-2f * eps; i++)
 	{
-		q.b = ferrari_koefs[2];
-		q.c = ferrari_koefs[0];
-		q.d = q.b * q.b - 4.f * q.c + 1e-4;
-		if (q.d >= 0.f)
-		{
-			q.d = sqrt(q.d);
-			(*solve)[0] = (-q.b - q.d) / 2.f;
-			(*solve)[1] = (-q.b + q.d) / 2.f;
-			if ((*solve)[0] >= 0.f)
-				(*solve)[0] = (q.res = -sqrt((*solve)[0]) - koefs[3] / 4.f) > 0.f ? q.res : sqrt((*solve)[0]) - koefs[3] / 4.f;
-			if ((*solve)[1] >= 0.f)
-				(*solve)[1] = (q.res = -sqrt((*solve)[1]) - koefs[3] / 4.f) > 0.f ? q.res : sqrt((*solve)[1]) - koefs[3] / 4.f;
-		}
-		return;
-	}
-	//y3+py2+qy+r=0
-	cubic_resol_koefs[2] = (-0.5f) * ferrari_koefs[2];
-	cubic_resol_koefs[1] = -ferrari_koefs[0];
-	cubic_resol_koefs[0] = (-0.125f) * ferrari_koefs[1] * ferrari_koefs[1] + 0.5f * ferrari_koefs[0] * ferrari_koefs[2];
-	p2 = cubic_resol_koefs[2] * cubic_resol_koefs[2];
-	//y3+py+q=0
-	cubic_two_params_koefs[1] = cubic_resol_koefs[1] - p2 / 3.f;
-	cubic_two_params_koefs[0] = cubic_resol_koefs[0] + 2.f * p2  * cubic_resol_koefs[2] / 27.f - cubic_resol_koefs[2] * cubic_resol_koefs[1] / 3.f;
-	//y = z+t, 3zt+p = 0
-	b2 = cubic_two_params_koefs[0] * cubic_two_params_koefs[0];
-	Q = cubic_two_params_koefs[1] * cubic_two_params_koefs[1] * cubic_two_params_koefs[1] / 27.f + cubic_two_params_koefs[0] * cubic_two_params_koefs[0] / 4.f;
-	if (Q > 0)
-		positive_discriminant(Q, cubic_two_params_koefs, &cubic_solve, cubic_resol_koefs[2] / 3.f);
-	else
-		negative_discriminant(Q, cubic_two_params_koefs, &cubic_solve, cubic_resol_koefs[2] / 3.f);
-	if ((q.b = 2.f * cubic_solve - ferrari_koefs[2]) > 0.f ) {
-		q.a = q.b;
-		q.b = -sqrt(q.b);
-		q.c = ferrari_koefs[1] / (-2.f * q.b) + cubic_solve;
-		q.d = q.a - 4.f * q.c + 1e-4;
-		if (q.d >= 0.f)
-		{
-			q.d = sqrt(q.d);
-			(*solve)[0] =
-					(q.res = (-q.b - q.d) / 2.f - koefs[3] / 4.f) > 0.f
-					? q.res : (-q.b + q.d) / 2.f - koefs[3] / 4.f;
-		}
-		q.b = -q.b;
-		q.c = ferrari_koefs[1] / (-2.f * q.b) + cubic_solve;
-		q.d = q.a - 4.f * q.c + 1e-4;
-		if (q.d >= 0.f)
-		{
-			q.d = sqrt(q.d);
-			(*solve)[1] =
-					(q.res = (-q.b - q.d) / 2.f - koefs[3] / 4.f) > 0.f
-					? q.res : (-q.b + q.d) / 2.f - koefs[3] / 4.f;
-		}
+		if (inside && d < 0.f)
+			b.y = t;
+		else if (inside)
+			b.x = t;
+		n = t - d / (side * torus_slope(o + ray->dir * t, ray->dir, axis,
+			torus->radius));
+		if (!(n >= b.x && n <= b.y) && !inside)
+			break ;
+		t = n >= b.x && n <= b.y ? n : 0.5f * (b.x + b.y);
+		d = side * torus_sdf(o + ray->dir * t, axis, torus->radius,
+			torus->tor_radius);
 	}
+	return (fabs(d) < eps && t > EPSILON && t <= far ? t : 0.f);
 }
 
-
-float intersection_torus(__global t_obj *torus, t_ray *ray)
+/* sphere tracing on the exact distance inside the clipped span. Rays that
+ * skim the surface would crawl along it, so a step is never shorter than
+ * what reaches the end of the span with the steps left. A step that ends
+ * inside leaves the crossing bracketed for torus_hit, only crossings
+ * thinner than a step, grazes within about eps, are stepped over. Rays
+ * starting on the surface (bounces) pick their side from the gradient and
+ * step off before looking for the next crossing */
+float			intersection_torus(__global t_geom *torus, t_ray *ray)
 {
-	__float3    x;
-	__float4 equation_koefs, dots,qq;
-	__float2 solve = (__float2){-1.f, -1.f};
-	float R2, r2, Rr, dist;
-
-	Rr = torus->radius + torus->tor_radius + 1;
-	x = ray->origin - torus->position;
-	dist = length(x) - Rr;
-	if (dist > 0.f)
-		x += ray->dir * dist;
-	else
-		dist = 0.f;
-	R2 = torus->radius * torus->radius;
-	r2 = torus->tor_radius * torus->tor_radius;
-	//ax4+bx3+cx2+dx1+e
-	//a == 1
-	dots[0] = dot(x, torus->v);
-	dots[1] = dot(ray->dir, torus->v);
-	dots[2] = dot(x, x);
-	dots[3] = dot(x, ray->dir);
-	qq[0] = 1.0f - dots[1] * dots[1];
-	qq[1] = 2.0f * (dots[3] - dots[0] * dots[1]);
-	qq[2] = dots[2] - dots[0] * dots[0];
-	qq[3] = dots[2] + R2 - r2;
-	equation_koefs[3] = 4.0f * dots[3];
-	equation_koefs[2] = 2.0f * qq[3] + equation_koefs[3] * equation_koefs[3] * 0.25f - 4.0f * R2 * qq[0];
-	equation_koefs[1] = equation_koefs[3] * qq[3] - 4.0f * R2 * qq[1];
-	equation_koefs[0] = qq[3] * qq[3] - 4.0f * R2 * qq[2];
-	fourth_degree_equation_solver(equation_koefs, &solve);
-
-	if(solve[0] > 0)
+	float3	o = ray->origin - torus->position;
+	float3	axis = normalize(torus->v);
+	float	eps = 1e-4f * (torus->radius + torus->tor_radius);
+	float2	span;
+	float	t;
+	float	d;
+	float	side;
+
+	if (!torus_span(o, ray, axis, torus->radius, torus->tor_radius, &span))
+		return (0.f);
+	t = span.x;
+	d = torus_sdf(o + ray->dir * t, axis, torus->radius, torus->tor_radius);
+	side = d < 0.f ? -1.f : 1.f;
+	if (fabs(d) < eps && t > 0.f)
+		return (torus_hit(torus, o, ray, (float2)(t, t), side, span.y));
+	if (fabs(d) < eps)
 	{
-		if(solve[1] > 0)
-			return (solve[0] < solve[1] ? solve[0] + dist : solve[1] + dist);
-		else
-			return (solve[0] + dist);
+		float3 p = o + ray->dir * t;
+		float3 core = p - dot(p, axis) * axis;
+		core = p - normalize(core) * torus->radius;
+		side = dot(core, ray->dir) < 0.f ? -1.f : 1.f;
+		t += 4.f * eps;
 	}
-	else if (solve[1] > 0)
-		return (solve[1] + dist);
-	else
-		return(0.f);
+	for (int i = 0; i < TORUS_STEPS && t <= span.y; i++)
+	{
+		d = side * torus_sdf(o + ray->dir * t, axis, torus->radius, torus->tor_radius);
+		if (d < eps)
+			return (torus_hit(torus, o, ray, (float2)(span.x, t), side,
+				span.y));
+		if (t == span.y)
+			break ;
+		span.x = t;
+		t = fmin(t + fmax(d, (span.y - t) / (TORUS_STEPS - i - 1)), span.y);
+	}
+	return (0.f);
 }
 
-
+static float	intersect_object(__global t_geom *object, t_ray *ray)
+{
+	if (object->type == SPHERE)
+		return (intersect_sphere(object, ray));
+	else if (object->type == CYLINDER)
+		return (intersect_cylinder(object, ray));
+	else if (object->type == CONE)
+		return (intersect_cone(object, ray));
+	else if (object->type == PLANE)
+		return (intersect_plane(object, ray));
+	else if (object->type == TRIANGLE)
+		return (intersect_triangle(object, ray));
+	else if (object->type == PARABOLOID)
+		return (intersect_parabol(object, ray));
+	else if (object->type == TORUS)
+		return (intersection_torus(object, ray));
+	return (0.f);
+}
@@ -0,0 +1,155 @@
+/* next event estimation. lights lists the emissive spheres, triangles and
+ * planes with a cdf over their power, geom.light_pick is the chance of
+ * picking an object. Every pdf here is per solid angle at the shading
+ * point, so light and bsdf samples can be weighted against each other. */
+
+static float	power_heuristic(float a, float b)
+{
+	a *= a;
+	b *= b;
+	return (a + b > 0.f ? a / (a + b) : 0.f);
+}
+
+static int		light_select(t_scene *scene, float u)
+{
+	int		lo = 0;
+	int		hi = scene->n_lights - 1;
+	int		mid;
+
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		if (scene->lights[mid].cdf > u)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return (scene->lights[lo].id);
+}
+
+/* 1 - cos of the cone a sphere subtends from d2 away, written so far
+ * lights keep their precision, 0 from inside */
+static float	sphere_cone(__global t_geom *g, float d2)
+{
+	float	r2 = g->radius * g->radius / d2;
+
+	return (r2 < 1.f ? r2 / (1.f + sqrt(1.f - r2)) : 0.f);
+}
+
+/* pdf of light sampling choosing dir from origin, t is the distance to the
+ * point dir reaches on the light */
+static float	light_pdf(t_scene *scene, int id, float3 origin, float3 dir, float t)
+{
+	__global t_geom	*g = &scene->objects[id];
+	float3			n;
+	float			c;
+
+	if (g->light_pick <= 0.f)
+		return (0.f);
+	if (g->type == SPHERE)
+	{
+		c = sphere_cone(g, dot(g->position - origin, g->position - origin));
+		return (c > 0.f ? g->light_pick / (2.f * PI * c) : 0.f);
+	}
+	if (g->type == PLANE)
+		return (g->light_pick * fabs(dot(dir, normalize(g->v))) * _1_PI);
+	n = cross(g->vertices[1] - g->vertices[0], g->vertices[2] - g->vertices[0]);
+	c = fabs(dot(normalize(n), dir)) * 0.5f * length(n);
+	return (c > 0.f ? g->light_pick * t * t / c : 0.f);
+}
+
+/* uniform in the cone the sphere subtends, t is the near intersection */
+static float	light_sphere(__global t_geom *g, float3 x, float3 *dir, float *pdf, t_scene *scene)
+{
+	float3	w = g->position - x;
+	float	d2 = dot(w, w);
+	float	cone = sphere_cone(g, d2);
+	float3	s;
+	float	sin_t;
+	float	phi;
+
+	if (cone <= 0.f)
+		return (0.f);
+	s.z = 1.f - rng(scene) * cone;
+	sin_t = sqrt(fmax(0.f, 1.f - s.z * s.z));
+	phi = 2.f * PI * rng(scene);
+	s.x = sin_t * cos(phi);
+	s.y = sin_t * sin(phi);
+	w = normalize(w);
+	*dir = sampler_transform(&w, &s);
+	*pdf = g->light_pick / (2.f * PI * cone);
+	sin_t = sqrt(d2) * s.z;
+	return (sin_t - sqrt(fmax(0.f, sin_t * sin_t - d2 + g->radius * g->radius)));
+}
+
+/* a cosine lobe around the normal facing x covers the whole plane */
+static float	light_plane(__global t_geom *g, float3 x, float3 *dir, float *pdf, t_scene *scene)
+{
+	float3	n = normalize(g->v);
+	float	side = dot(x - g->position, n);
+	float	c;
+
+	if (fabs(side) < EPSILON)
+		return (0.f);
+	n = side > 0.f ? -n : n;
+	*dir = sample_cosine(&n, scene);
+	c = dot(*dir, n);
+	if (c < EPSILON)
+		return (0.f);
+	*pdf = g->light_pick * c * _1_PI;
+	return (fabs(side) / c);
+}
+
+/* picks a light by power and a direction towards it. Returns the distance
+ * to the sampled point, 0 when the light can not be sampled from x */
+static float	light_sample(t_scene *scene, float3 x, float3 *dir, float *pdf, int *id)
+{
+	__global t_geom	*g;
+	float3			w;
+	float			u;
+	float			v;
+	float			t;
+
+	*pdf = 0.f;
+	*id = light_select(scene, rng(scene));
+	g = &scene->objects[*id];
+	if (g->type == SPHERE)
+		return (light_sphere(g, x, dir, pdf, scene));
+	if (g->type == PLANE)
+		return (light_plane(g, x, dir, pdf, scene));
+	u = sqrt(rng(scene));
+	v = rng(scene);
+	w = (1.f - u) * g->vertices[0] + u * (1.f - v) * g->vertices[1]
+		+ u * v * g->vertices[2] - x;
+	t = length(w);
+	*dir = w / t;
+	*pdf = light_pdf(scene, *id, x, *dir, t);
+	return (*pdf > 0.f ? t : 0.f);
+}
+
+/* bsdf * cos towards wi for the lobe bsdf_sample draws from when it does
+ * not refract, and the pdf it would have drawn wi with */
+static float	bsdf_eval(t_obj *object, float3 normal, float3 dir, float3 wi, float *pdf)
+{
+	float3	h;
+	float	alpha2;
+	float	cos_o = -dot(dir, normal);
+	float	cos_i = dot(wi, normal);
+	float	d;
+
+	*pdf = 0.f;
+	if (cos_o <= 0.f || cos_i <= 0.f)
+		return (0.f);
+	if (object->metalness <= 0.f)
+	{
+		*pdf = cos_i * _1_PI;
+		return (*pdf);
+	}
+	alpha2 = ggx_alpha(object->metalness);
+	alpha2 *= alpha2;
+	h = normalize(wi - dir);
+	d = dot(h, normal);
+	d = alpha2 / (PI * (d * d * (alpha2 - 1.f) + 1.f) * (d * d * (alpha2 - 1.f) + 1.f));
+	*pdf = d * dot(h, normal) / (4.f * fabs(dot(dir, h)));
+	return (d * ggx_g1(cos_o, alpha2) * ggx_g1(cos_i, alpha2) / (4.f * cos_o));
+}
@@ -10,7 +10,7 @@ static float u_clamp(float x)
 
 static int	c_floor(float x)
 {
-	return (x < 0.0f ? 0 : x > 255.f ? 255 : (char)floor(x));
+	return (x < 0.0f ? 0 : x > 255.f ? 255 : (int)floor(x));
 }
 
 static int toInt(float x)
@@ -0,0 +1,122 @@
+/* indexed triangle meshes: every mesh object owns a subtree of mesh_nodes
+ * rooted at mesh_root, leaves index mesh_tris and the corners index the
+ * shared mesh_data array of positions, normals and uvs */
+
+/* moller-trumbore, returns the distance or 0 on a miss */
+static float	mesh_triangle(t_scene *scene, int tri, t_ray *ray)
+{
+	__global t_tri	*t = &scene->mesh_tris[tri];
+	float3			a = scene->mesh_data[t->v[0]];
+	float3			e1 = scene->mesh_data[t->v[1]] - a;
+	float3			e2 = scene->mesh_data[t->v[2]] - a;
+	float3			p = cross(ray->dir, e2);
+	float			det = dot(e1, p);
+	float3			s;
+	float3			q;
+	float			u;
+	float			v;
+
+	if (fabs(det) < 1e-12f)
+		return (0.f);
+	det = 1.f / det;
+	s = ray->origin - a;
+	u = dot(s, p) * det;
+	if (u < 0.f || u > 1.f)
+		return (0.f);
+	q = cross(s, e1);
+	v = dot(ray->dir, q) * det;
+	if (v < 0.f || u + v > 1.f)
+		return (0.f);
+	det *= dot(e2, q);
+	return (det > EPSILON ? det : 0.f);
+}
+
+/* same traversal as the scene bvh, on a private copy of the ray so the
+ * caller still sees the closest hit of the other objects. Without prim
+ * any triangle before ray->t ends the search, for shadow rays */
+float			mesh_intersect(t_scene *scene, __global t_geom *object,
+				t_ray *ray, int *prim)
+{
+	int		stack[BVH_STACK];
+	float	dist[BVH_STACK];
+	int		top = 0;
+	int		node = object->mesh_root;
+	float3	inv_dir = 1.f / ray->dir;
+	t_ray	r = *ray;
+	float	d;
+
+	while (node >= 0)
+	{
+		__global t_bvh_node *cur = &scene->mesh_nodes[node];
+		if (cur->count < 0)
+		{
+			int		first = node + 1;
+			int		second = cur->start;
+			float	t_first = bvh_box(&scene->mesh_nodes[first], &r, inv_dir);
+			float	t_second = bvh_box(&scene->mesh_nodes[second], &r, inv_dir);
+			if (t_second < t_first)
+			{
+				first = cur->start;
+				second = node + 1;
+				float swap = t_first;
+				t_first = t_second;
+				t_second = swap;
+			}
+			if (t_first < INFINITY)
+			{
+				if (t_second < INFINITY && top < BVH_STACK)
+				{
+					stack[top] = second;
+					dist[top++] = t_second;
+				}
+				node = first;
+				continue ;
+			}
+		}
+		else
+			for (int i = cur->start; i < cur->start + cur->count; i++)
+				if ((d = mesh_triangle(scene, i, &r)) != 0.f && d < r.t)
+				{
+					if (!prim)
+						return (d);
+					r.t = d;
+					*prim = i;
+				}
+		node = bvh_pop(stack, dist, &top, r.t);
+	}
+	return (r.t < ray->t ? r.t : 0.f);
+}
+
+/* turns the private copy of the hit mesh into the triangle that was hit,
+ * with the interpolated vertex normal in v when the file had them.
+ * Returns 1 when coord got the interpolated texture coordinate */
+int				mesh_hit(t_scene *scene, t_obj *object,
+				t_intersection *intersection, float2 *coord)
+{
+	__global t_tri	*t = &scene->mesh_tris[intersection->prim];
+	float3			e1;
+	float3			e2;
+	float3			w;
+	float			area;
+
+	object->type = TRIANGLE;
+	for (int k = 0; k < 3; k++)
+		object->vertices[k] = scene->mesh_data[t->v[k]];
+	e1 = object->vertices[1] - object->vertices[0];
+	e2 = object->vertices[2] - object->vertices[0];
+	object->v = cross(e1, e2);
+	area = dot(object->v, object->v);
+	w = intersection->hitpoint - object->vertices[0];
+	w.y = dot(cross(w, e2), object->v) / area;
+	w.z = dot(cross(e1, intersection->hitpoint - object->vertices[0]), object->v) / area;
+	w.x = 1.f - w.y - w.z;
+	object->v = normalize(object->v);
+	if (t->n[0] >= 0 && t->n[1] >= 0 && t->n[2] >= 0)
+		object->v = normalize(w.x * scene->mesh_data[t->n[0]] +
+			w.y * scene->mesh_data[t->n[1]] + w.z * scene->mesh_data[t->n[2]]);
+	if (t->t[0] < 0 || t->t[1] < 0 || t->t[2] < 0)
+		return (0);
+	*coord = w.x * scene->mesh_data[t->t[0]].xy +
+		w.y * scene->mesh_data[t->t[1]].xy + w.z * scene->mesh_data[t->t[2]].xy;
+	return (1);
+}
@@ -1,13 +1,13 @@
 #include "options.cl"
 
-static float3			interpolate_color_as_vector(int color)
+static float3			interpolate_color_as_vector(float3 color)
 {
 	float3				new_color;
 
 	// new_color.x = ((float)(color & 255) / 255.f) * 2.f - 1.f;
 	// new_color.y = ((float)((color >> 8) & 255) / 255.f) * 2.f - 1.f;
 	// new_color.z = ((float)((color >> 16) & 255) / 255.f);
-	new_color = cl_int_to_float3(color);
+	new_color = color;
 	new_color.xz = new_color.zx;
 	new_color.x = new_color.x * 2.f - 1.f;
 	new_color.y = new_color.y * 2.f - 1.f;
@@ -53,15 +53,14 @@ static float3			sphere_normal_map(t_obj *object, t_intersection *intersection, f
 	return (end_vector);
 }
 
-float3					int_vect(t_obj *object, float2 *coord, t_scene *scene)
+float3					int_vect(t_obj *object, float2 *coord, t_scene *scene, __read_only image2d_t atlas)
 {
 	float3				inter_vector;
 
 	if (object->normal > 0)
 	{
-		__global t_txture *normal_map = &((scene->normals)[object->normal - 1]);
-		int i = normal_map->texture[((int)(coord->y * (float)(normal_map->height))) * (normal_map->width) + (int)(coord->x * (float)(normal_map->width))];
-		inter_vector = interpolate_color_as_vector(i);
+		float4 texel = tex_sample(atlas, &((scene->normals)[object->normal - 1]), *coord);
+		inter_vector = interpolate_color_as_vector(texel.xyz);
 	}
 	else
 	{
@@ -72,11 +71,11 @@ float3					int_vect(t_obj *object, float2 *coord, t_scene *scene)
 	return (inter_vector);
 }
 
-float3					normal_map(t_obj *object, t_intersection *intersection, float3 normal, float2 *coord, t_scene *scene)
+float3					normal_map(t_obj *object, t_intersection *intersection, float3 normal, float2 *coord, t_scene *scene, __read_only image2d_t atlas)
 {
 	float3				inter_vector;
 
-	inter_vector = int_vect(object, coord, scene);
+	inter_vector = int_vect(object, coord, scene, atlas);
 	if (object->type == PLANE)
 	 	normal = plane_normal_map(object, intersection, normal, coord, inter_vector);
 	else if (object->type == CYLINDER)
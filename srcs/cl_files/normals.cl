@@ -32,7 +32,7 @@ static float3 plane_get_normal(t_obj *object, t_intersection *intersection)
 	return (object->v);
 }
 
-float3 get_normal(t_obj *object, t_intersection *intersection, float2 *coord, t_scene *scene)
+float3 get_normal(t_obj *object, t_intersection *intersection, float2 *coord, t_scene *scene, __read_only image2d_t atlas)
 {
 	float3 normal;
 
@@ -65,7 +65,7 @@ float3 get_normal(t_obj *object, t_intersection *intersection, float2 *coord, t_
 	// 	normal = -normal;
 	if (object->normal != 0)
 	{
-		normal = normal_map(object, intersection, normal, coord, scene);
+		normal = normal_map(object, intersection, normal, coord, scene, atlas);
 	}
 	return (normal);
 }
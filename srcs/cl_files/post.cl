@@ -0,0 +1,84 @@
+/* display time post process. Sample launches only accumulate, these run
+ * once per shown frame on the finished accumulation (or on the denoised
+ * image) so no kernel reads pixels another one is still writing. */
+
+#define POST_GROUP 64
+#define POST_RADIUS 32
+#define POST_HEAT 1
+#define POST_STEREO 2
+#define POST_SEPIA 4
+
+/* one direction of the separable gaussian, 3 sigma wide as the old 2D
+ * mask was. A work group covers POST_GROUP pixels of a row (or of a
+ * column when axis is set) and loads them with the apron on both sides
+ * into local memory once, borders repeat the edge pixel. The global size
+ * is padded to the group. */
+__kernel void	post_blur_kernel(__global float3 *in, __global float3 *out,
+				float inv, float sigma, int axis, int2 size)
+{
+	__local float3	tile[POST_GROUP + 2 * POST_RADIUS];
+	int				radius = min((int)ceil(3.f * sigma), POST_RADIUS);
+	int				along = get_global_id(0);
+	int				lid = get_local_id(0);
+	int				len = axis ? size.y : size.x;
+	int				step = axis ? size.x : 1;
+	int				base = axis ? get_global_id(1) : get_global_id(1) * size.x;
+	int				first = get_group_id(0) * POST_GROUP - radius;
+	float3			sum = (float3)(0.f);
+	float			wsum = 0.f;
+	float			wk;
+
+	for (int i = lid; i < POST_GROUP + 2 * radius; i += POST_GROUP)
+		tile[i] = in[base + clamp(first + i, 0, len - 1) * step] * inv;
+	barrier(CLK_LOCAL_MEM_FENCE);
+	if (along >= len)
+		return ;
+	for (int k = -radius; k <= radius; k++)
+	{
+		wk = exp(-(float)(k * k) / (2.f * sigma * sigma));
+		sum += tile[lid + radius + k] * wk;
+		wsum += wk;
+	}
+	out[base + along * step] = sum / wsum;
+}
+
+/* adaptive sampling heat map, blue pixels stopped early, red ones took
+ * every sample so far */
+static int	sample_heat(int spp, int samples)
+{
+	float	t = clamp((float)abs(spp) / (float)samples, 0.f, 1.f);
+
+	return (ft_rgb_to_hex(toInt(t), toInt(4.f * t * (1.f - t)), toInt(1.f - t)));
+}
+
+/* tonemap, look up table and 8-bit pack in one pass. The tonemap is the
+ * clamp to [0, 1] the frame always had. The table maps a channel to its
+ * cartoon step, or a gray level to its sepia tint, the host rebuilds it
+ * when the camera switches either. Stereo is the red-blue anaglyph of
+ * the two eyes. */
+__kernel void	post_kernel(__global float3 *in, __global float3 *in1,
+				__global int *spp, __constant int *lut, __global int *output,
+				float inv, int samples, int mode)
+{
+	int		p = get_global_id(0) + get_global_id(1) * get_global_size(0);
+	float3	c = in[p] * inv;
+	int3	v;
+
+	if (mode & POST_HEAT)
+	{
+		output[p] = sample_heat(spp[p], samples);
+		return ;
+	}
+	if (mode & POST_STEREO)
+	{
+		output[p] = ft_rgb_to_hex(toInt((c.x + c.y + c.z) / 3.f), 0,
+			toInt(dot(in1[p], (float3)(1.f)) / 3.f / samples));
+		return ;
+	}
+	v = (int3)(toInt(c.x), toInt(c.y), toInt(c.z));
+	if (mode & POST_SEPIA)
+		output[p] = lut[toInt((c.x + c.y + c.z) / 3.f)];
+	else
+		output[p] = (lut[v.x] & 0xFF0000) | (lut[v.y] & 0xFF00)
+			| (lut[v.z] & 0xFF);
+}
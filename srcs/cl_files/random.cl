@@ -1,31 +1,38 @@
 #include "kernel.hl"
 #include "options.cl"
 
-static float		rng_lgc(global ulong *rng_state)
+/* PCG hash (Jarzynski, Olano), a stateless permutation of one uint */
+static uint			pcg_hash(uint v)
 {
-	int				gi;
-	ulong			x;
-
-	gi = get_global_id(0);
-	x = rng_state[gi];
-	x = (0x5DEECE66DL * x + 0xBL) & ((1L << 32) - 1);
-	rng_state[gi] = x;
-    return ((float)x / (1L << 32));
+	uint			state;
+	uint			word;
+
+	state = v * 747796405u + 2891336453u;
+	word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+	return ((word >> 22u) ^ word);
+}
+
+/* keys a stream by scene seed, pixel, sample index and bounce; draws only
+ * hash an increasing counter, so nothing is kept in device memory */
+static void			rng_seed(t_scene *scene, uint pixel, uint sample, uint bounce)
+{
+	scene->rng_key = pcg_hash(scene->seed ^ pcg_hash(pixel ^ pcg_hash(sample ^ pcg_hash(bounce))));
+	scene->rng_count = 0;
 }
 
-static float		rng(global ulong *rng_state)
+static float		rng(t_scene *scene)
 {
-	return (rng_lgc(rng_state));
+	return ((float)(pcg_hash(scene->rng_key + scene->rng_count++) >> 8) / 16777216.f);
 }
 
-static float3		sphere_random(global t_obj *object, global ulong *rnd)
+static float3		sphere_random(global t_geom *object, t_scene *scene)
 {
 	float 			theta;
 	float 			phi;
 	float3			random;
 
-	theta = rng(rnd) * PI;
-	phi = rng(rnd) * 2 * PI;
+	theta = rng(scene) * PI;
+	phi = rng(scene) * 2 * PI;
 	random.x = 0.5 * object->radius * sin(theta) * cos(phi);
 	random.y = 0.5 * object->radius * sin(theta) * sin(phi);
 	random.z = 0.5 * object->radius * cos(theta);
@@ -57,28 +64,69 @@ static float3		sampler_transform(float3 *normal, float3 *sample)
 	return (convert_sample(normal, sample, &nt, &nb));
 }
 
-static float3		sample_uniform
-					(float3 *normal,
-					t_scene * scene, float metalness)
+/* cosine weighted hemisphere around normal, pdf = cos / PI, so a lambert
+ * bsdf times the cosine over the pdf leaves just the surface colour */
+static float3		sample_cosine(float3 *normal, t_scene *scene)
 {
-	float3 			r;
-	float3			ret;
-	// float 			phi, theta;
-	// float 			thetasin;
-
-	metalness = cos(PI * 0.5f * metalness);
-	// phi = rng(scene->random) * 2 * PI;
-	// theta = rng(scene->random) * 2 * PI;
-	// thetasin = sin(theta);
-	// r.x = thetasin * cos(phi) * metalness;
-	// r.y = thetasin * sin(phi) * metalness;
-	// r.z = sqrt(fabs(1.f - r.x * r.x - r.y * r.y));
-	// r = normalize(r);
-	r.x = (rng(scene->random) * 2.f - 1.f);
-	r.y = ((rng(scene->random) * 2.f - 1.f)) * sqrt(1.f - r.x * r.x);
-	r *= metalness;
-	r.z = sqrt(fabs(1.f - r.y * r.y - r.x * r.x));
-	ret = sampler_transform(normal, &r);
-	return (ret);
+	float			r;
+	float			phi;
+	float3			sample;
+
+	r = rng(scene);
+	phi = 2.f * PI * rng(scene);
+	sample.z = sqrt(1.f - r);
+	r = sqrt(r);
+	sample.x = r * cos(phi);
+	sample.y = r * sin(phi);
+	return (sampler_transform(normal, &sample));
 }
 
+/* trowbridge-reitz roughness, metalness 1 is a mirror */
+static float		ggx_alpha(float metalness)
+{
+	float			rough;
+
+	rough = 1.f - clamp(metalness, 0.f, 1.f);
+	return (fmax(rough * rough, 1e-3f));
+}
+
+/* smith masking for one direction, alpha2 is the squared roughness */
+static float		ggx_g1(float cosine, float alpha2)
+{
+	return (2.f * cosine / (cosine + sqrt(alpha2 + (1.f - alpha2) * cosine * cosine)));
+}
+
+/* samples the half vector h from D(h) * cos(h) and reflects dir about it,
+ * pdf = D(h) * cos(h) / (4 * |dir.h|). D cancels in bsdf * cos / pdf, the
+ * weight left is G * |dir.h| / (cos_o * cos(h)), zero below the surface */
+static float3		sample_ggx(float3 *normal, float3 dir, t_scene *scene,
+					float alpha, float *weight, float *pdf)
+{
+	float			alpha2;
+	float			u;
+	float			phi;
+	float3			h;
+	float3			out;
+	float			cos_o;
+	float			cos_i;
+
+	alpha2 = alpha * alpha;
+	u = rng(scene);
+	phi = 2.f * PI * rng(scene);
+	h.z = sqrt((1.f - u) / (1.f + (alpha2 - 1.f) * u));
+	u = sqrt(fmax(0.f, 1.f - h.z * h.z));
+	h.x = u * cos(phi);
+	h.y = u * sin(phi);
+	u = h.z;
+	h = sampler_transform(normal, &h);
+	out = dir - 2.f * dot(dir, h) * h;
+	cos_o = -dot(dir, *normal);
+	cos_i = dot(out, *normal);
+	phi = u * u * (alpha2 - 1.f) + 1.f;
+	*pdf = alpha2 * u / (PI * phi * phi * 4.f * fabs(dot(dir, h)));
+	*weight = 0.f;
+	if (cos_o > 0.f && cos_i > 0.f)
+		*weight = ggx_g1(cos_o, alpha2) * ggx_g1(cos_i, alpha2)
+			* fabs(dot(dir, h)) / (cos_o * u);
+	return (out);
+}
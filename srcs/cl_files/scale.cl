@@ -0,0 +1,26 @@
+/* stretches the frame traced at 1/scale of the window over the output
+ * while the view changes, bilinear between the centers of the low pixels.
+ * cl_int_to_float3 keeps red in z, the pack below puts it back. */
+
+__kernel void	upscale_kernel(__global int *low, __global int *output,
+				int low_w, int low_h, int scale)
+{
+	int2	pos = (int2)(get_global_id(0), get_global_id(1));
+	float2	last = (float2)(low_w - 1, low_h - 1);
+	float2	src = ((float2)(pos.x, pos.y) + 0.5f) / (float)scale - 0.5f;
+	int2	a;
+	int2	b;
+	float2	f;
+	float3	c;
+
+	src = clamp(src, (float2)(0.f), last);
+	a = convert_int2(src);
+	b = min(a + 1, convert_int2(last));
+	f = src - (float2)(a.x, a.y);
+	c = mix(mix(cl_int_to_float3(low[a.x + a.y * low_w]),
+			cl_int_to_float3(low[b.x + a.y * low_w]), f.x),
+		mix(cl_int_to_float3(low[a.x + b.y * low_w]),
+			cl_int_to_float3(low[b.x + b.y * low_w]), f.x), f.y);
+	output[pos.x + pos.y * get_global_size(0)] =
+		ft_rgb_to_hex(toInt(c.z), toInt(c.y), toInt(c.x));
+}
@@ -81,22 +81,34 @@ float3					wave(float2 *coord, t_obj *object)
 		return (object->color * (sin(len) * 0.5f + 0.5f));
 }
 
-float3					get_color(t_obj *object, float3 hitpoint, t_scene *scene, float2 *coord)
+constant sampler_t		g_atlas_sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_LINEAR;
+
+/* every texture is a rectangle of the atlas image, the bilinear footprint
+ * is kept half a texel inside it so neighbours never bleed in */
+float4					tex_sample(__read_only image2d_t atlas, __global t_txture *texture, float2 uv)
+{
+	float2				size;
+	float2				pos;
+
+	size = (float2)(texture->width, texture->height);
+	pos = clamp(uv * size, (float2)(0.5f), size - 0.5f);
+	return (read_imagef(atlas, g_atlas_sampler, (float2)(texture->x, texture->y) + pos));
+}
+
+float3					get_color(t_obj *object, float3 hitpoint, t_scene *scene, float2 *coord, __read_only image2d_t atlas)
 {
-	__global t_txture	*texture;
-	int					i;
+	float4				color;
 
 	if (object->texture > 0)
 	{
-		texture = &((scene->textures)[object->texture - 1]);
-		i = ((int)(coord->y * (float)(texture->height))) * (texture->width) + (int)(coord->x * (float)(texture->width));
+		color = tex_sample(atlas, &((scene->textures)[object->texture - 1]), *coord);
 	if (object->transparency == 0)
 		{
-			object->transparency = 1.f - (float)(texture->texture[i] >> 24 & 0xFF) / 255.f;
+			object->transparency = 1.f - color.w;
 			if (object->transparency > 0.99)
 				return ((float3)(1.f, 1.f, 1.f));
 		}
-		return (cl_int_to_float3(texture->texture[i]));
+		return (color.xyz);
 	}
 	else if (object->texture == -1)
 		return (chess(object, coord));
@@ -114,18 +126,13 @@ float3					get_color(t_obj *object, float3 hitpoint, t_scene *scene, float2 *coo
 		return (object->color);
 }
 
-float3					global_texture(t_ray *ray, t_scene *scene)
+float3					global_texture(t_ray *ray, t_scene *scene, __read_only image2d_t atlas)
 {
 	float3				vect;
-	__global t_txture	*texture;
-	float				u;
-	float				v;
-	int					i;
+	float2				uv;
 
 	vect = ray->dir;
-	u = 0.5 + (atan2(vect.z, vect.x)) / (2 * PI);
-	v = 0.5 - (asin(vect.y)) / PI;
-	texture = &((scene->textures)[scene->global_texture_id]);
-	i = ((int)(v * (float)(texture->height - 1))) * (texture->width) + (int)(u * (float)(texture->width - 1));
-	return(cl_int_to_float3(texture->texture[i]));
+	uv.x = 0.5 + (atan2(vect.z, vect.x)) / (2 * PI);
+	uv.y = 0.5 - (asin(vect.y)) / PI;
+	return(tex_sample(atlas, &((scene->textures)[scene->global_texture_id]), uv).xyz);
 }
@@ -0,0 +1,415 @@
+/* wavefront path tracing: generate fills the first ray queue, then every
+ * bounce extend intersects the queued rays, shade runs the material and
+ * compacts surviving paths into the next queue, and connect traces the
+ * shadow rays of the light samples shade took. A path slot is its pixel
+ * index, plus one bucket per view before it for the second stereo eye.
+ * counters[RAY_COUNT] sums the rays traced so the benchmark can read it,
+ * counters[PATH_COUNT + b] the paths that were still alive at bounce b.
+ * counters[ACTIVE_COUNT + f] count the pixels adapt listed as unconverged,
+ * the two lists swap every launch so generate reads one while adapt
+ * fills the other. */
+
+#define WAVE_SCENE_ARGS __global t_geom *objects,\
+	__global t_surface *surfaces, __global t_txture *textures, __global t_txture *normals,\
+	__global t_bvh_node *bvh, __global int *bvh_index,\
+	__global float3 *mesh_data, __global t_tri *mesh_tris,\
+	__global t_bvh_node *mesh_nodes, __read_only image2d_t atlas,\
+	__global t_light *lights, t_wave wave
+#define WAVE_SCENE(s) wave_scene(s, objects, surfaces, textures, normals,\
+	bvh, bvh_index, mesh_data, mesh_tris, mesh_nodes, lights, &wave)
+#define SHADOW_COUNT 2
+#define RAY_COUNT 3
+#define ACTIVE_COUNT 4
+#define PATH_COUNT 6
+#define ADAPT_MIN 8
+#define ADAPT_ERROR 0.02f
+#define ADAPT_FLOOR 0.05f
+
+/* path slots index the bucket in flight, random numbers follow the pixel
+ * of the whole image so buckets do not repeat each other's noise. Both
+ * eyes share them, which keeps their noise alike */
+static uint		wave_pixel(t_wave *wave, int p)
+{
+	p %= wave->width * wave->height;
+	return ((wave->tile_y + p / wave->width) * wave->image_w + wave->tile_x + p % wave->width);
+}
+
+static void		wave_scene(t_scene *scene, __global t_geom *objects,
+				__global t_surface *surfaces, __global t_txture *textures, __global t_txture *normals,
+				__global t_bvh_node *bvh, __global int *bvh_index,
+				__global float3 *mesh_data, __global t_tri *mesh_tris,
+				__global t_bvh_node *mesh_nodes, __global t_light *lights,
+				t_wave *wave)
+{
+	scene->objects = objects;
+	scene->surfaces = surfaces;
+	scene->n_objects = wave->n_objects;
+	scene->seed = wave->seed;
+	scene->textures = textures;
+	scene->normals = normals;
+	scene->camera = wave->camera;
+	scene->lightsampling = wave->lightsampling;
+	scene->global_texture_id = wave->global_texture_id;
+	scene->width = wave->image_w;
+	scene->height = wave->image_h;
+	scene->samples = 0;
+	scene->bvh = bvh;
+	scene->bvh_index = bvh_index;
+	scene->n_unbounded = wave->n_unbounded;
+	scene->mesh_data = mesh_data;
+	scene->mesh_tris = mesh_tris;
+	scene->mesh_nodes = mesh_nodes;
+	scene->lights = lights;
+	scene->n_lights = wave->n_lights;
+}
+
+/* joins the geometry of a hit object with its material into the private
+ * record shading works on, traversal only ever reads the geometry */
+static t_obj	obj_load(t_scene *scene, int id)
+{
+	__global t_geom		*g = &scene->objects[id];
+	__global t_surface	*s = &scene->surfaces[g->material];
+	t_obj				obj;
+
+	obj.type = g->type;
+	obj.radius = g->radius;
+	obj.tor_radius = g->tor_radius;
+	obj.position = g->position;
+	obj.v = g->v;
+	for (int k = 0; k < 3; k++)
+	{
+		obj.vertices[k] = g->vertices[k];
+		obj.basis[k] = s->basis[k];
+	}
+	obj.is_visible = g->is_visible;
+	obj.mesh_root = g->mesh_root;
+	obj.color = s->color;
+	obj.emission = s->emission;
+	obj.metalness = s->metalness;
+	obj.texture = s->texture;
+	obj.normal = s->normal;
+	obj.shift = s->shift;
+	obj.prolapse = s->prolapse;
+	obj.transparency = s->transparency;
+	obj.refraction = s->refraction;
+	return (obj);
+}
+
+/* emission a bsdf sample ran into, weighted against the light sample of
+ * the previous bounce that could have found it too. Without lights to
+ * sample (n_lights is 0 when the host turns light sampling off) the bsdf
+ * sample is the only estimate and keeps its full weight */
+static float	emission_weight(t_scene *scene, int id, t_ray *ray, float pdf)
+{
+	if (pdf < 0.f || !scene->n_lights)
+		return (1.f);
+	return (power_heuristic(pdf, light_pdf(scene, id, ray->origin, ray->dir, ray->t)));
+}
+
+/* samples one light for the hit and queues the shadow ray that decides
+ * whether its contribution counts. Without a following bsdf bounce the
+ * light sample is the only estimate and keeps its full weight */
+static void		light_connect(t_scene *scene, t_obj *object, t_intersection *intersection,
+				float3 dir, float3 weight, int mis, t_shadow *shadow)
+{
+	float3		normal = intersection->normal * -sign(dot(intersection->normal, dir));
+	float3		wi;
+	float		lpdf;
+	float		bpdf;
+	float		f;
+	float		t;
+	int			id;
+
+	t = light_sample(scene, intersection->hitpoint, &wi, &lpdf, &id);
+	if (t <= 0.f || id == intersection->object_id)
+		return ;
+	f = bsdf_eval(object, normal, dir, wi, &bpdf);
+	if (f <= 0.f)
+		return ;
+	shadow->dir = wi * t;
+	shadow->weight = weight * scene->surfaces[scene->objects[id].material].emission
+		* (f / lpdf * (mis ? power_heuristic(lpdf, bpdf) : 1.f));
+	shadow->queued = 1;
+}
+
+/* one bounce of the former trace loop, returns 0 when the path ends here.
+ * pdf comes in as the pdf of the bsdf sample that led here and leaves as
+ * the one of the new direction, -1 after a refraction */
+static int		shade_hit(t_scene *scene, t_intersection *intersection,
+				t_ray *ray, float3 *mask, float3 *rad, float *pdf,
+				int bounce, int last, __read_only image2d_t atlas, t_shadow *shadow)
+{
+	t_obj		objecthit = obj_load(scene, intersection->object_id);
+	float2		img_coord;
+	int			uv_done;
+	float3		newdir;
+	float		bsdf;
+
+	intersection->hitpoint = ray->origin + ray->dir * ray->t;
+	uv_done = objecthit.type == MESH && mesh_hit(scene, &objecthit, intersection, &img_coord);
+	if (!uv_done && (objecthit.normal != 0 || objecthit.texture != 0))
+		interpolate_uv(&objecthit, intersection->hitpoint, scene, &img_coord);
+	objecthit.color = get_color(&objecthit, intersection->hitpoint, scene, &img_coord, atlas);
+	intersection->material.color = objecthit.color;
+	if (length(objecthit.emission) != 0.0f && bounce == 0)
+	{
+		*rad += objecthit.color;
+		return (0);
+	}
+	/* compute the surface normal and flip it if necessary to face the incoming ray */
+	intersection->normal = get_normal(&objecthit, intersection, &img_coord, scene, atlas);
+	if (scene->lightsampling)
+		intersection->normal *= -sign(dot(intersection->normal, ray->dir));
+	if (length(objecthit.emission) != 0.0f)
+		*rad += *mask * objecthit.emission * emission_weight(scene, intersection->object_id, ray, *pdf);
+	*rad += *mask * (scene->camera.ambience);
+	newdir = bsdf_sample(&objecthit, intersection->normal, ray->dir, scene, &bsdf, pdf);
+	shadow->queued = 0;
+	shadow->point = intersection->hitpoint;
+	if (*pdf >= 0.f && scene->n_lights)
+		light_connect(scene, &objecthit, intersection, ray->dir, *mask * objecthit.color, !last, shadow);
+	*mask *= objecthit.color * bsdf;
+	ray->dir = newdir;
+	ray->origin = intersection->hitpoint + ray->dir * EPSILON;
+	return (1);
+}
+
+/* russian roulette: past min_bounces a path survives with a probability
+ * that follows its throughput and the survivors are weighted up by its
+ * inverse, so dark paths stop early without biasing the image */
+static int		roulette(t_scene *scene, float3 *mask, int bounce, int min_bounces)
+{
+	float		q;
+
+	if (bounce < min_bounces)
+		return (1);
+	q = fmin(fmax(mask->x, fmax(mask->y, mask->z)), 0.95f);
+	if (rng(scene) >= q)
+		return (0);
+	*mask /= q;
+	return (1);
+}
+
+/* the view is the second dimension, its camera comes from cams */
+__kernel void	generate_kernel(WAVE_SCENE_ARGS, __global float3 *ray_o,
+				__global float3 *ray_d, __global float3 *throughput,
+				__global int *queue, __global int *counters,
+				__global int *active, __global t_cam *cams)
+{
+	t_scene		scene;
+	t_ray		ray;
+	int			frame = wave.total / SAMPLES;
+	bool		listed = wave.adaptive && frame > 1;
+	int			pixels = wave.width * wave.height;
+	int			view = get_global_id(1);
+	int			paths = pixels;
+	int			p;
+
+	WAVE_SCENE(&scene);
+	scene.camera = cams[view];
+	active += ((frame - 1) & 1) * pixels;
+	if (listed)
+		paths = counters[ACTIVE_COUNT + ((frame - 1) & 1)];
+	queue += view * paths;
+	for (int i = get_global_id(0); i < paths; i += get_global_size(0))
+	{
+		p = listed ? active[i] : i;
+		scene.x_coord = wave.tile_x + p % wave.width;
+		scene.y_coord = wave.tile_y + p / wave.width;
+		rng_seed(&scene, wave_pixel(&wave, p), wave.sample, 0);
+		createCamRay(&scene, &ray);
+		p += view * pixels;
+		ray_o[p] = ray.origin;
+		ray_d[p] = ray.dir;
+		throughput[p] = 1.0f;
+		queue[i] = p;
+	}
+	if (get_global_id(0) == 0 && view == 0)
+	{
+		counters[wave.q_in] = paths * wave.views;
+		counters[ACTIVE_COUNT + (frame & 1)] = 0;
+	}
+}
+
+__kernel void	extend_kernel(WAVE_SCENE_ARGS, __global float3 *ray_o,
+				__global float3 *ray_d, __global float *hit_t,
+				__global int *hit_id, __global int *hit_prim,
+				__global int *queue_in, __global int *counters)
+{
+	t_scene			scene;
+	t_intersection	intersection;
+	t_ray			ray;
+	int				p;
+
+	WAVE_SCENE(&scene);
+	if (get_global_id(0) == 0)
+	{
+		counters[!wave.q_in] = 0;
+		counters[SHADOW_COUNT] = 0;
+		counters[RAY_COUNT] += counters[wave.q_in];
+		counters[PATH_COUNT + wave.bounce] += counters[wave.q_in];
+	}
+	for (int i = get_global_id(0); i < counters[wave.q_in]; i += get_global_size(0))
+	{
+		p = queue_in[i];
+		ray.origin = ray_o[p];
+		ray.dir = ray_d[p];
+		hit_id[p] = intersect_scene(&scene, &intersection, &ray) ? intersection.object_id : -1;
+		hit_prim[p] = intersection.prim;
+		hit_t[p] = ray.t;
+	}
+}
+
+__kernel void	shade_kernel(WAVE_SCENE_ARGS, __global float3 *ray_o,
+				__global float3 *ray_d, __global float3 *throughput,
+				__global float *hit_t, __global int *hit_id,
+				__global int *hit_prim,
+				__global int *queue_in, __global int *queue_out,
+				__global int *counters, __global float3 *radiance,
+				__global float3 *sh_point, __global float3 *sh_dir,
+				__global float3 *sh_weight, __global int *shadow_queue,
+				__global float *ray_pdf, __global float3 *albedo,
+				__global float3 *normal, __global float *depth,
+				__global float3 *radiance1)
+{
+	t_scene			scene;
+	t_intersection	intersection;
+	t_ray			ray;
+	t_shadow		shadow;
+	float3			mask;
+	float3			rad;
+	float3			view;
+	float			pdf;
+	int				last = wave.bounce + 1 >= wave.bounces;
+	int				pixels = wave.width * wave.height;
+	int				p;
+	__global float3	*eye;
+
+	WAVE_SCENE(&scene);
+	for (int i = get_global_id(0); i < counters[wave.q_in]; i += get_global_size(0))
+	{
+		p = queue_in[i];
+		eye = p < pixels ? radiance + p : radiance1 + p - pixels;
+		ray.origin = ray_o[p];
+		ray.dir = ray_d[p];
+		ray.t = hit_t[p];
+		mask = throughput[p];
+		pdf = ray_pdf[p];
+		rng_seed(&scene, wave_pixel(&wave, p), wave.sample, 2 * wave.bounce + 1);
+		rad = *eye;
+		intersection.object_id = hit_id[p];
+		intersection.prim = hit_prim[p];
+		intersection.normal = -ray.dir;
+		view = ray.dir;
+		/* if ray misses scene, add background colour */
+		if (intersection.object_id < 0 || length(mask) < EPSILON)
+		{
+			intersection.material.color = global_texture(&ray, &scene, atlas);
+			intersection.normal = 0.f;
+			rad += mask * intersection.material.color;
+		}
+		else if (shade_hit(&scene, &intersection, &ray, &mask, &rad, &pdf, wave.bounce, last, atlas, &shadow))
+		{
+			if (shadow.queued)
+			{
+				sh_point[p] = shadow.point;
+				sh_dir[p] = shadow.dir;
+				sh_weight[p] = shadow.weight;
+				shadow_queue[atomic_inc(&counters[SHADOW_COUNT])] = p;
+			}
+			if (!last && roulette(&scene, &mask, wave.bounce + 1, wave.min_bounces))
+			{
+				ray_o[p] = ray.origin;
+				ray_d[p] = ray.dir;
+				ray_pdf[p] = pdf;
+				throughput[p] = mask;
+				queue_out[atomic_inc(&counters[!wave.q_in])] = p;
+			}
+		}
+		/* first hit features of the denoiser, the first sample after a
+		 * reset traces every pixel. Stereo is never denoised */
+		if (wave.bounce == 0 && wave.sample == 0 && p < pixels)
+		{
+			albedo[p] = intersection.material.color;
+			normal[p] = intersection.normal * -sign(dot(intersection.normal, view));
+			depth[p] = intersection.object_id < 0 ? 0.f : ray.t;
+		}
+		*eye = rad;
+	}
+}
+
+/* a light sample counts when nothing is hit before the sampled point,
+ * sh_dir spans from the shading point to it */
+__kernel void	connect_kernel(WAVE_SCENE_ARGS, __global int *counters,
+				__global float3 *radiance, __global float3 *sh_point,
+				__global float3 *sh_dir, __global float3 *sh_weight,
+				__global int *shadow_queue, __global float3 *radiance1)
+{
+	t_scene			scene;
+	t_ray			ray;
+	float			dist;
+	int				pixels = wave.width * wave.height;
+	int				p;
+	__global float3	*eye;
+
+	WAVE_SCENE(&scene);
+	if (get_global_id(0) == 0)
+		counters[RAY_COUNT] += counters[SHADOW_COUNT];
+	for (int i = get_global_id(0); i < counters[SHADOW_COUNT]; i += get_global_size(0))
+	{
+		p = shadow_queue[i];
+		dist = length(sh_dir[p]);
+		ray.dir = sh_dir[p] / dist;
+		ray.origin = sh_point[p] + ray.dir * EPSILON;
+		eye = p < pixels ? radiance + p : radiance1 + p - pixels;
+		if (!occluded(&scene, &ray, dist * 0.999f - 2.f * EPSILON))
+			*eye += sh_weight[p];
+	}
+}
+
+static float	luminance(float3 c)
+{
+	return (0.2126f * c.x + 0.7152f * c.y + 0.0722f * c.z);
+}
+
+/* runs once per launch after the samples are traced. Every launch of
+ * SAMPLES samples is one batch, moment sums the squared batch means so the
+ * variance of the pixel estimate is the batch variance over the batch
+ * count. A pixel whose relative error fell under ADAPT_ERROR stores its
+ * count negated and from then on gets its running mean written into
+ * radiance, so vect_temp / samples stays the image for every pixel. */
+__kernel void	adapt_kernel(WAVE_SCENE_ARGS, __global float3 *radiance,
+				__global float3 *vect_temp, __global float *moment,
+				__global int *spp, __global int *active, __global int *counters)
+{
+	int		paths = wave.width * wave.height;
+	int		frame = wave.total / SAMPLES;
+	int		n;
+	float	lum;
+	float	mean;
+	float	batches;
+	float	bound;
+
+	active += (frame & 1) * paths;
+	for (int p = get_global_id(0); p < paths; p += get_global_size(0))
+	{
+		n = frame > 1 ? spp[p] : 0;
+		if (n < 0)
+		{
+			radiance[p] = vect_temp[p] * (float)SAMPLES / (float)(wave.total - SAMPLES);
+			continue ;
+		}
+		lum = luminance(radiance[p]) / SAMPLES;
+		moment[p] = (n ? moment[p] : 0.f) + lum * lum;
+		n += SAMPLES;
+		batches = n / SAMPLES;
+		mean = luminance(vect_temp[p] + radiance[p]) / n;
+		bound = ADAPT_ERROR * fmax(mean, ADAPT_FLOOR);
+		if (wave.adaptive && batches >= ADAPT_MIN
+			&& moment[p] / batches - mean * mean <= bound * bound * batches)
+			n = -n;
+		else
+			active[atomic_inc(&counters[ACTIVE_COUNT + (frame & 1)])] = p;
+		spp[p] = n;
+	}
+}
@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   atlas.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/20 12:08:51 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:02:40 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	atlas_place(t_atlas *atlas, t_txture *tex, int *shelf_h)
+{
+	if (atlas->img_x + tex->width > atlas->img_w)
+	{
+		atlas->img_x = 0;
+		atlas->img_h += *shelf_h;
+		*shelf_h = 0;
+	}
+	tex->x = atlas->img_x;
+	tex->y = atlas->img_h;
+	atlas->img_x += tex->width;
+	if (tex->height > *shelf_h)
+		*shelf_h = tex->height;
+}
+
+static int	atlas_widest(t_game *game)
+{
+	int		widest;
+	int		i;
+
+	widest = 0;
+	i = -1;
+	while (++i < game->textures_num)
+		if (game->textures[i].width > widest)
+			widest = game->textures[i].width;
+	i = -1;
+	while (++i < game->normals_num)
+		if (game->normals[i].width > widest)
+			widest = game->normals[i].width;
+	return (widest);
+}
+
+static void	atlas_shelves(t_game *game)
+{
+	int		i;
+	int		shelf_h;
+
+	game->atlas.img_x = 0;
+	game->atlas.img_h = 0;
+	shelf_h = 0;
+	i = -1;
+	while (++i < game->textures_num)
+		atlas_place(&game->atlas, &game->textures[i], &shelf_h);
+	i = -1;
+	while (++i < game->normals_num)
+		atlas_place(&game->atlas, &game->normals[i], &shelf_h);
+	game->atlas.img_h += shelf_h;
+}
+
+static void	atlas_overflow(t_atlas *atlas, int widest)
+{
+	fprintf(stderr, "texture atlas needs %dx%d pixels, the device images "
+	"take at most %dx%d\n", widest > atlas->img_w ? widest : atlas->img_w,
+	atlas->img_h, atlas->max_w, atlas->max_h);
+	terminate("textures and normal maps do not fit into one device image");
+}
+
+/*
+** Shelf packing of every texture and normal map into one 2d image, rows
+** are at least as wide as the widest texture and roughly square overall.
+** max_w and max_h bound the image when set, a pack that comes out too
+** tall is tried again as wide as the device allows.
+*/
+
+void		atlas_pack(t_game *game)
+{
+	t_atlas	*atlas;
+	int		widest;
+
+	atlas = &game->atlas;
+	widest = atlas_widest(game);
+	atlas->img_w = (int)ceil(sqrt((double)atlas->size));
+	if (widest > atlas->img_w)
+		atlas->img_w = widest;
+	if (atlas->max_w && atlas->img_w > atlas->max_w)
+		atlas->img_w = atlas->max_w;
+	atlas_shelves(game);
+	if (atlas->max_h && atlas->img_h > atlas->max_h
+	&& atlas->img_w < atlas->max_w)
+	{
+		atlas->img_w = atlas->max_w;
+		atlas_shelves(game);
+	}
+	if ((atlas->max_w && widest > atlas->max_w)
+	|| (atlas->max_h && atlas->img_h > atlas->max_h))
+		atlas_overflow(atlas, widest);
+}
@@ -0,0 +1,114 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   atlas_upload.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 23:02:40 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:02:40 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	atlas_device(t_atlas *atlas, cl_device_id device)
+{
+	size_t	max_w;
+	size_t	max_h;
+
+	max_w = 0;
+	max_h = 0;
+	clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH, sizeof(size_t),
+	&max_w, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT, sizeof(size_t),
+	&max_h, NULL);
+	if (max_w && max_w < (size_t)atlas->max_w)
+		atlas->max_w = (int)max_w;
+	if (max_h && max_h < (size_t)atlas->max_h)
+		atlas->max_h = (int)max_h;
+}
+
+/*
+** The atlas is one image the whole context shares, it has to fit the
+** smallest image every device of the context takes.
+*/
+
+void		atlas_limits(t_game *game)
+{
+	cl_context		context;
+	cl_device_id	*devices;
+	cl_uint			num;
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	num = 0;
+	clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES, sizeof(cl_uint), &num,
+	NULL);
+	devices = malloc_exit(sizeof(cl_device_id) * (num + 1));
+	clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(cl_device_id) * num,
+	devices, NULL);
+	game->atlas.max_w = INT_MAX;
+	game->atlas.max_h = INT_MAX;
+	while (num--)
+		atlas_device(&game->atlas, devices[num]);
+	free(devices);
+}
+
+/*
+** Copies each texture into its place in img, an image of the atlas size.
+*/
+
+void		atlas_blit(t_atlas *atlas, t_txture *tex, int num, cl_int *img)
+{
+	int		i;
+	int		row;
+
+	i = -1;
+	while (++i < num)
+	{
+		row = -1;
+		while (++row < tex[i].height)
+			ft_memcpy(img + (size_t)(tex[i].y + row) * atlas->img_w + tex[i].x,
+			atlas->pixels + tex[i].offset + (size_t)row * tex[i].width,
+			sizeof(cl_int) * tex[i].width);
+	}
+}
+
+static void	atlas_image(t_game *game, cl_int *img)
+{
+	cl_image_format	format;
+	cl_image_desc	desc;
+	cl_context		context;
+
+	format.image_channel_order = CL_RGBA;
+	format.image_channel_data_type = CL_UNORM_INT8;
+	ft_bzero(&desc, sizeof(cl_image_desc));
+	desc.image_type = CL_MEM_OBJECT_IMAGE2D;
+	desc.image_width = game->atlas.img_w;
+	desc.image_height = game->atlas.img_h;
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	if (game->atlas.image)
+		clReleaseMemObject(game->atlas.image);
+	game->atlas.image = clCreateImage(context, CL_MEM_READ_ONLY |
+	CL_MEM_COPY_HOST_PTR, &format, &desc, img, &game->cl_info->ret);
+}
+
+void		atlas_upload(t_game *game)
+{
+	cl_int	*img;
+	size_t	size;
+
+	size = sizeof(cl_int) * game->atlas.img_w * game->atlas.img_h;
+	img = malloc_exit(size);
+	ft_bzero(img, size);
+	atlas_blit(&game->atlas, game->textures, game->textures_num, img);
+	atlas_blit(&game->atlas, game->normals, game->normals_num, img);
+	atlas_image(game, img);
+	free(img);
+	if (game->cl_info->ret != CL_SUCCESS)
+		terminate("could not create the texture atlas image\n");
+	clSetKernelArg(game->cl_info->progs[0].krls[0].krl, 15, sizeof(cl_mem),
+	&game->atlas.image);
+}
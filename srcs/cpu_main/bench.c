@@ -0,0 +1,106 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 14:02:45 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:11:05 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	bench_usage(void)
+{
+	terminate("usage: ./RT --bench [--spp N] [--out results.json] "
+	"[scene.json ...]");
+}
+
+static void	bench_args(t_bench *bench, int argc, char **argv)
+{
+	int		i;
+
+	ft_bzero(bench, sizeof(t_bench));
+	bench->spp = SAMPLES * 4;
+	bench->scenes = malloc_exit(sizeof(char *) * argc);
+	bench->scenes_cap = argc;
+	i = 1;
+	while (++i < argc)
+	{
+		if (!ft_strcmp(argv[i], "--spp") && i + 1 < argc)
+			bench->spp = ft_atoi(argv[++i]);
+		else if (!ft_strcmp(argv[i], "--out") && i + 1 < argc)
+			bench->out = argv[++i];
+		else if (argv[i][0] != '-')
+			bench_push(bench, ft_strdup(argv[i]));
+		else
+			bench_usage();
+	}
+	if (bench->spp <= 0)
+		bench_usage();
+	if (!bench->scenes_num)
+		bench_scenes(bench);
+}
+
+/*
+** Scene parsing, bvh build and upload count as load, render is the wall
+** time of the sample loop and readback fetches the float accumulation.
+*/
+
+static void	bench_scene(t_game *game, t_bench *bench, char *scene)
+{
+	Uint64		time;
+	cl_float3	*pixels;
+
+	pixels = malloc_exit(sizeof(cl_float3) * game->frame.cap);
+	time = SDL_GetPerformanceCounter();
+	opencl(game, scene);
+	bench->host_ms[BENCH_LOAD] = bench_ms(time);
+	bench_reset(game, bench);
+	time = SDL_GetPerformanceCounter();
+	while (game->gpu.samples < bench->spp)
+	{
+		ft_run_kernel(game, &game->cl_info->progs[0].krls[0]);
+		bench_rays(game);
+	}
+	ft_display(game);
+	present_flush(game);
+	bench->host_ms[BENCH_RENDER] = bench_ms(time);
+	time = SDL_GetPerformanceCounter();
+	game->cl_info->ret = cl_read(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[2],
+	sizeof(cl_float3) * game->frame.cap, pixels);
+	bench->host_ms[BENCH_READBACK] = bench_ms(time);
+	free(pixels);
+}
+
+int			bench_main(int argc, char **argv)
+{
+	t_game		game;
+	t_gui		gui;
+	t_bench		bench;
+	int			i;
+
+	bench_args(&bench, argc, argv);
+	frame_init(&game, WIN_W, WIN_H, 0);
+	headless_setup(&game, &gui, 0);
+	bench_open(&game, &bench);
+	i = -1;
+	while (++i < bench.scenes_num)
+	{
+		bench_scene(&game, &bench, bench.scenes[i]);
+		bench_report(&game, &bench, bench.scenes[i], !i);
+		cl_krl_mem_release_all(game.cl_info, &game.cl_info->progs[0].krls[0]);
+		free_list(&game);
+		game.texture_list = NULL;
+		game.textures_num = 0;
+		game.normal_list = NULL;
+		game.normals_num = 0;
+		ft_memdel((void **)&game.music);
+	}
+	bench_close(&bench);
+	SDL_FreeSurface(game.sdl.surface);
+	return (0);
+}
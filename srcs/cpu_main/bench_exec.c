@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_exec.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 14:02:45 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 16:42:08 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Profiling has to be requested when a queue is created, so the queue
+** cl_init made is swapped for one on the same context and device.
+*/
+
+void		bench_queue(t_game *game)
+{
+	cl_context		context;
+	cl_device_id	device;
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_DEVICE,
+	sizeof(cl_device_id), &device, NULL);
+	clReleaseCommandQueue(game->cl_info->cmd_queue);
+	game->cl_info->cmd_queue = clCreateCommandQueue(context, device,
+	CL_QUEUE_PROFILING_ENABLE, &game->cl_info->ret);
+	if (game->cl_info->ret != CL_SUCCESS)
+		terminate("could not create a profiling command queue\n");
+}
+
+/*
+** Every launch of render_kernel and the wavefront stages goes through
+** here, while benchmarking the events are kept until bench_collect.
+*/
+
+void		krl_exec(t_game *game, int krl, cl_uint dim, size_t *global)
+{
+	t_bench		*bench;
+
+	bench = game->bench;
+	if (!bench)
+	{
+		game->cl_info->ret = cl_krl_exec(game->cl_info,
+		game->cl_info->progs[0].krls[krl].krl, dim, global);
+		return ;
+	}
+	if (bench->events_num == BENCH_EVENTS)
+		bench_collect(game);
+	game->cl_info->ret = clEnqueueNDRangeKernel(game->cl_info->cmd_queue,
+	game->cl_info->progs[0].krls[krl].krl, dim, NULL, global, NULL, 0, NULL,
+	&bench->events[bench->events_num]);
+	bench->event_krl[bench->events_num++] = krl;
+}
+
+/*
+** Same for the 2D launches that need their work group size, the ones that
+** share local memory.
+*/
+
+void		krl_exec_local(t_game *game, int krl, size_t *global, size_t *local)
+{
+	t_bench		*bench;
+	cl_event	*event;
+
+	bench = game->bench;
+	event = NULL;
+	if (bench && bench->events_num == BENCH_EVENTS)
+		bench_collect(game);
+	if (bench)
+	{
+		event = &bench->events[bench->events_num];
+		bench->event_krl[bench->events_num++] = krl;
+	}
+	game->cl_info->ret = clEnqueueNDRangeKernel(game->cl_info->cmd_queue,
+	game->cl_info->progs[0].krls[krl].krl, 2, NULL, global, local, 0, NULL,
+	event);
+}
+
+void		bench_collect(t_game *game)
+{
+	t_bench		*bench;
+	cl_ulong	time[2];
+	int			i;
+
+	bench = game->bench;
+	if (!bench || !bench->events_num)
+		return ;
+	clWaitForEvents(bench->events_num, bench->events);
+	i = -1;
+	while (++i < bench->events_num)
+	{
+		clGetEventProfilingInfo(bench->events[i], CL_PROFILING_COMMAND_START,
+		sizeof(cl_ulong), &time[0], NULL);
+		clGetEventProfilingInfo(bench->events[i], CL_PROFILING_COMMAND_END,
+		sizeof(cl_ulong), &time[1], NULL);
+		bench->kernel_ns[bench->event_krl[i]] += time[1] - time[0];
+		bench->launches[bench->event_krl[i]]++;
+		clReleaseEvent(bench->events[i]);
+	}
+	bench->events_num = 0;
+}
+
+double		bench_ms(Uint64 from)
+{
+	return ((double)(SDL_GetPerformanceCounter() - from) * 1000.0
+	/ (double)SDL_GetPerformanceFrequency());
+}
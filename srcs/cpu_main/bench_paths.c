@@ -0,0 +1,71 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_paths.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/25 17:31:52 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/26 12:04:17 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Extend and connect add the size of their queue to counters[RAY_COUNT],
+** extend also adds the paths alive at each bounce after it. They are
+** drained after every frame so they can not overflow.
+*/
+
+void		bench_rays(t_game *game)
+{
+	cl_int	counters[COUNTERS];
+	int		i;
+
+	game->cl_info->ret = cl_read(game->cl_info, game->wf.counters,
+	sizeof(counters), counters);
+	game->bench->rays += (cl_uint)counters[RAY_COUNT];
+	i = -1;
+	while (++i < MAX_BOUNCES)
+		game->bench->paths[i] += (cl_uint)counters[PATH_COUNT + i];
+	counters[RAY_COUNT] = 0;
+	ft_bzero(counters + PATH_COUNT, sizeof(cl_int) * MAX_BOUNCES);
+	game->cl_info->ret = cl_write(game->cl_info, game->wf.counters,
+	sizeof(counters), counters);
+}
+
+void		bench_reset(t_game *game, t_bench *bench)
+{
+	ft_bzero(bench->kernel_ns, sizeof(bench->kernel_ns));
+	ft_bzero(bench->launches, sizeof(bench->launches));
+	bench_rays(game);
+	bench->rays = 0;
+	ft_bzero(bench->paths, sizeof(bench->paths));
+}
+
+/*
+** Paths entering every bounce and the share of the previous bounce that
+** survived the roulette, the first min bounces only lose paths that miss.
+*/
+
+void		bench_paths(t_game *game, t_bench *bench)
+{
+	FILE	*fp;
+	int		i;
+
+	fp = bench->fp;
+	fprintf(fp, "            \"bounces\": {\"min\": %d, \"max\": %d},\n",
+	game->min_bounces, game->max_bounces);
+	fprintf(fp, "            \"paths\": [");
+	i = -1;
+	while (++i < game->max_bounces)
+		fprintf(fp, "%s%llu", i ? ", " : "",
+		(unsigned long long)bench->paths[i]);
+	fprintf(fp, "],\n            \"survival\": [");
+	i = 0;
+	while (++i < game->max_bounces)
+		fprintf(fp, "%s%.3f", i > 1 ? ", " : "", bench->paths[i - 1] ?
+		(double)bench->paths[i] / bench->paths[i - 1] : 0.0);
+	fprintf(fp, "],\n");
+}
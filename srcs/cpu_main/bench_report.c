@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_report.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 14:02:45 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:11:05 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	bench_device(t_game *game, FILE *fp)
+{
+	cl_device_id	device;
+	cl_device_type	type;
+	char			name[256];
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_DEVICE,
+	sizeof(cl_device_id), &device, NULL);
+	ft_bzero(name, sizeof(name));
+	clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(name) - 1, name, NULL);
+	clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, NULL);
+	fprintf(fp, "    \"device\": {\"name\": \"%s\", \"type\": \"%s\"},\n", name,
+	type & CL_DEVICE_TYPE_CPU ? "cpu" : (type & CL_DEVICE_TYPE_GPU ? "gpu"
+	: "other"));
+}
+
+/*
+** Switches the game to profiled launches and starts the results document.
+*/
+
+void		bench_open(t_game *game, t_bench *bench)
+{
+	bench_queue(game);
+	game->bench = bench;
+	game->keys.r = 1;
+	bench->fp = stdout;
+	if (bench->out && !(bench->fp = fopen(bench->out, "w")))
+		terminate(bench->out);
+	fprintf(bench->fp, "{\n");
+	bench_device(game, bench->fp);
+	fprintf(bench->fp, "    \"resolution\": [%d, %d],\n", game->frame.w,
+	game->frame.h);
+	fprintf(bench->fp, "    \"spp\": %d,\n", bench->spp);
+	fprintf(bench->fp, "    \"scenes\": [");
+}
+
+static void	bench_kernels(t_bench *bench)
+{
+	FILE	*fp;
+	cl_uint	launches;
+	int		i;
+
+	fp = bench->fp;
+	fprintf(fp, "            \"kernel_ms\": {\"generate\": %.3f, ",
+	bench->kernel_ns[WF_GENERATE] / 1e6);
+	fprintf(fp, "\"extend\": %.3f, \"shade\": %.3f, ",
+	bench->kernel_ns[WF_EXTEND] / 1e6, bench->kernel_ns[WF_SHADE] / 1e6);
+	fprintf(fp, "\"connect\": %.3f, \"adapt\": %.3f, \"resolve\": %.3f, ",
+	bench->kernel_ns[WF_CONNECT] / 1e6, bench->kernel_ns[WF_ADAPT] / 1e6,
+	bench->kernel_ns[0] / 1e6);
+	fprintf(fp, "\"denoise\": %.3f, \"post\": %.3f},\n",
+	(bench->kernel_ns[DN_INIT] + bench->kernel_ns[DN_PASS] +
+	bench->kernel_ns[DN_FINAL]) / 1e6, (bench->kernel_ns[POST_BLUR] +
+	bench->kernel_ns[POST_PACK]) / 1e6);
+	launches = 0;
+	i = -1;
+	while (++i < KERNELS)
+		launches += bench->launches[i];
+	fprintf(fp, "            \"launches\": %u\n", launches);
+}
+
+void		bench_report(t_game *game, t_bench *bench, char *scene, int first)
+{
+	FILE	*fp;
+	double	seconds;
+
+	fp = bench->fp;
+	seconds = bench->host_ms[BENCH_RENDER] / 1000.0;
+	fprintf(fp, "%s\n        {\n", first ? "" : ",");
+	fprintf(fp, "            \"scene\": \"%s\",\n", scene);
+	fprintf(fp, "            \"samples\": %d,\n", game->gpu.samples);
+	fprintf(fp, "            \"rays\": %llu,\n",
+	(unsigned long long)bench->rays);
+	fprintf(fp, "            \"mrays_per_s\": %.3f,\n",
+	bench->rays / seconds / 1e6);
+	fprintf(fp, "            \"samples_per_s\": %.0f,\n",
+	(double)game->gpu.samples * game->frame.w * game->frame.h / seconds);
+	fprintf(fp, "            \"host_ms\": {\"load\": %.3f, \"render\": %.3f, "
+	"\"readback\": %.3f},\n", bench->host_ms[BENCH_LOAD],
+	bench->host_ms[BENCH_RENDER], bench->host_ms[BENCH_READBACK]);
+	bench_paths(game, bench);
+	bench_kernels(bench);
+	fprintf(fp, "        }");
+	fflush(fp);
+}
+
+void		bench_close(t_bench *bench)
+{
+	fprintf(bench->fp, "\n    ]\n}\n");
+	if (bench->fp != stdout)
+		fclose(bench->fp);
+	while (bench->scenes_num--)
+		free(bench->scenes[bench->scenes_num]);
+	free(bench->scenes);
+}
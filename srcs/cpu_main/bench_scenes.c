@@ -0,0 +1,64 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_scenes.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 23:11:05 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:11:05 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Appends a scene the bench owns, the list doubles when it is full.
+*/
+
+void		bench_push(t_bench *bench, char *scene)
+{
+	char	**grown;
+
+	if (!scene)
+		terminate("Malloc ne ok\n");
+	if (bench->scenes_num == bench->scenes_cap)
+	{
+		bench->scenes_cap = bench->scenes_cap ? bench->scenes_cap * 2 : 8;
+		grown = malloc_exit(sizeof(char *) * bench->scenes_cap);
+		ft_memcpy(grown, bench->scenes, sizeof(char *) * bench->scenes_num);
+		free(bench->scenes);
+		bench->scenes = grown;
+	}
+	bench->scenes[bench->scenes_num++] = scene;
+}
+
+/*
+** Without scenes on the command line every json in scenes/ is rendered,
+** sorted by name so the results of two runs line up.
+*/
+
+void		bench_scenes(t_bench *bench)
+{
+	DIR				*dir;
+	struct dirent	*entry;
+	char			*buff;
+	int				i;
+
+	if (!(dir = opendir("scenes")))
+		terminate("scenes");
+	while ((entry = readdir(dir)))
+		if (ft_strstr(entry->d_name, ".json"))
+		{
+			bench_push(bench, ft_strjoin("scenes/", entry->d_name));
+			i = bench->scenes_num - 1;
+			while (i > 0 && ft_strcmp(bench->scenes[i - 1],
+			bench->scenes[i]) > 0)
+			{
+				buff = bench->scenes[i];
+				bench->scenes[i] = bench->scenes[i - 1];
+				bench->scenes[--i] = buff;
+			}
+		}
+	closedir(dir);
+}
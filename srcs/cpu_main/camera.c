@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/18 18:50:13 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 19:04:27 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/27 18:10:30 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,15 +14,11 @@
 
 static void	mouse_mov_switch(t_game *game)
 {
+	scale_motion(game);
 	game->cl_info->ret =
 	cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[2],
-	sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W, game->gpu.vec_temp);
-	game->cl_info->ret =
-	cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[11],
-	sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W, game->gpu.vec_temp1);
-	game->cl_info->ret = cl_write(game->cl_info,
-	game->cl_info->progs[0].krls[0].args[1],
-	sizeof(t_obj) * game->obj_quantity, game->gpu.objects);
+	sizeof(cl_float3) * game->frame.cap, game->gpu.vec_temp);
+	obj_flush(game);
 	game->gpu.samples = 0;
 	game->flag = 1;
 }
@@ -31,14 +27,12 @@ static void	mouse_mov(t_game *game, t_gui *gui)
 {
 	if (game->flag)
 	{
+		scale_motion(game);
 		game->cl_info->ret =
 		cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[2],\
-	sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W, game->gpu.vec_temp);
-		game->cl_info->ret =
-		cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[11],
-	sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W, game->gpu.vec_temp1);
+	sizeof(cl_float3) * game->frame.cap, game->gpu.vec_temp);
 		game->gpu.samples = 0;
-		reconfigure_camera(&game->gpu.camera[game->cam_num]);
+		reconfigure_camera(game, &game->gpu.camera[game->cam_num]);
 		cam_rename(game, gui, game->cam_num);
 		if (gui->c_c.show && game->keys.show_gui\
 		&& game->cam_num == gui->c_c.cam_id)
@@ -0,0 +1,108 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   check.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 23:24:31 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:52:16 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	check_usage(void)
+{
+	terminate("usage: ./RT --mischeck|--splitcheck scene.json [--spp N] "
+	"[--threads N]");
+}
+
+static void	check_args(t_check *check, int argc, char **argv)
+{
+	int		i;
+
+	ft_bzero(check, sizeof(t_check));
+	check->spp = CHECK_SPP;
+	i = 1;
+	while (++i < argc)
+	{
+		if (!ft_strcmp(argv[i], "--spp") && i + 1 < argc)
+			check->spp = ft_atoi(argv[++i]);
+		else if (!ft_strcmp(argv[i], "--threads") && i + 1 < argc)
+			check->threads = ft_atoi(argv[++i]);
+		else if (argv[i][0] != '-' && !check->scene)
+			check->scene = argv[i];
+		else
+			check_usage();
+	}
+	if (!check->scene || check->spp <= 0 || check->threads < 0)
+		check_usage();
+}
+
+/*
+** Both means are printed, the check fails when a channel of the two
+** differs by more than CHECK_ERROR of the larger one.
+*/
+
+int			check_report(t_check *check, char *first, char *second)
+{
+	double	err;
+	double	worst;
+	int		i;
+
+	worst = 0.0;
+	i = -1;
+	while (++i < 3)
+	{
+		err = fabs(check->mean[0][i] - check->mean[1][i])
+		/ fmax(fmax(check->mean[0][i], check->mean[1][i]), 1e-6);
+		worst = fmax(worst, err);
+	}
+	printf("%s: %d spp\n    %-16s %.6f %.6f %.6f\n    %-16s %.6f %.6f %.6f\n"
+	"    differ by %.2f%%, %s\n", check->scene, check->spp, first,
+	check->mean[0][0], check->mean[0][1], check->mean[0][2], second,
+	check->mean[1][0], check->mean[1][1], check->mean[1][2], worst * 100.0,
+	worst <= CHECK_ERROR ? "ok" : "FAILED");
+	return (worst <= CHECK_ERROR ? 0 : 1);
+}
+
+/*
+** Fails when a pixel of a split render differs from the single device
+** one by more than CHECK_PIXEL.
+*/
+
+int			check_worst(t_check *check)
+{
+	int		fail;
+	int		i;
+
+	fail = 0;
+	i = -1;
+	while (++i < 2)
+	{
+		printf("    %-8s worst pixel %.2e, next to a seam %.2e\n",
+		i ? "raw" : "denoised", check->worst[i][0], check->worst[i][1]);
+		fail |= check->worst[i][0] > CHECK_PIXEL;
+	}
+	printf("    %s\n", fail ? "FAILED" : "ok");
+	return (fail);
+}
+
+/*
+** Renders that have to agree with each other, the exit status is what
+** the comparison found.
+*/
+
+int			check_main(int argc, char **argv)
+{
+	t_check	check;
+
+	if (ft_strcmp(argv[1], "--mischeck") && ft_strcmp(argv[1],
+	"--splitcheck"))
+		headless_usage();
+	check_args(&check, argc, argv);
+	if (!ft_strcmp(argv[1], "--splitcheck"))
+		return (splitcheck_main(&check));
+	return (mischeck_main(&check));
+}
@@ -0,0 +1,68 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cl_flags.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/25 16:52:44 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:44:17 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** The extension list has no fixed length, its size is asked first. A
+** device whose list cannot be read counts as one without cl_khr_fp64.
+*/
+
+static int	cl_device_fp64(cl_device_id device)
+{
+	size_t	size;
+	char	*ext;
+	int		fp64;
+
+	size = 0;
+	if (clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, 0, NULL, &size)
+	!= CL_SUCCESS || !size)
+		return (0);
+	ext = malloc_exit(size + 1);
+	fp64 = clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, size, ext, NULL)
+	== CL_SUCCESS;
+	ext[size] = '\0';
+	fp64 = fp64 && ft_strstr(ext, "cl_khr_fp64");
+	free(ext);
+	return (fp64);
+}
+
+/*
+** The kernels only use float math. The program is built for every device
+** of the context, unsuffixed literals stay double only when all of them
+** have cl_khr_fp64, otherwise they are demoted to float so it builds.
+*/
+
+char		*cl_build_flags(t_game *game)
+{
+	cl_context		context;
+	cl_device_id	*devices;
+	cl_uint			num;
+	int				fp64;
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	num = 0;
+	clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES, sizeof(cl_uint), &num,
+	NULL);
+	devices = malloc_exit(sizeof(cl_device_id) * (num + 1));
+	clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(cl_device_id) * num,
+	devices, NULL);
+	fp64 = num > 0;
+	while (fp64 && num--)
+		fp64 = cl_device_fp64(devices[num]);
+	free(devices);
+	if (fp64)
+		return ("-w -I srcs/cl_files/ -I includes/cl_headers/");
+	return ("-w -cl-single-precision-constant "
+	"-I srcs/cl_files/ -I includes/cl_headers/");
+}
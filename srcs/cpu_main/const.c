@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/18 20:04:28 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 17:34:03 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/27 23:24:31 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,7 +14,8 @@
 
 static void	set_keys(t_game *game)
 {
-	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+	if (!game->headless &&
+		Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
 	{
 		print_error_gui("Could not initialize mixer ", Mix_GetError());
 		exit(1);
@@ -53,9 +54,15 @@ static void	set_const_c(t_game *game, t_gui *gui)
 	game->texture_list = NULL;
 	game->textures_num = 0;
 	game->samples_to_do = 0;
-	game->vertices_list = NULL;
-	game->vertices_num = 0;
 	game->mask = NULL;
+	ft_bzero(&game->bvh, sizeof(t_bvh));
+	ft_bzero(&game->mesh, sizeof(t_mesh));
+	ft_bzero(&game->atlas, sizeof(t_atlas));
+	gui->main_screen = 0;
+	game->bench = NULL;
+	game->keys.heat = 0;
+	game->keys.adaptive = 1;
+	game->keys.nee = 1;
 	set_keys(game);
 }
 
@@ -69,7 +76,7 @@ void		set_const(t_game *game, t_gui *gui)
 		print_error_gui("No IMG for you: ", IMG_GetError());
 		exit(1);
 	}
-	if (SDLNet_Init() == -1)
+	if (!game->headless && SDLNet_Init() == -1)
 	{
 		print_error_gui("SDLNet_Init: %s\n", SDLNet_GetError());
 		exit(2);
@@ -83,5 +90,6 @@ void		set_const(t_game *game, t_gui *gui)
 	gui->flag = 0;
 	gui->sdl = game->sdl;
 	gui->quit = 0;
+	gui->game = game;
 	set_const_c(game, gui);
 }
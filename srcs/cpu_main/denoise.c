@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   denoise.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/26 15:21:40 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 16:42:08 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	denoise_exec(t_game *game, int krl, int idx, cl_int value)
+{
+	size_t	global[2];
+
+	global[0] = game->frame.tw;
+	global[1] = game->frame.th;
+	if (idx >= 0)
+		game->cl_info->ret |= clSetKernelArg(
+		game->cl_info->progs[0].krls[krl].krl, idx, sizeof(cl_int), &value);
+	krl_exec(game, krl, 2, global);
+}
+
+/*
+** Shade writes the first hit features into the denoiser buffers, the two
+** passes ping-pong through the wavelet levels.
+*/
+
+void		denoise_init(t_game *game)
+{
+	t_denoise	*dn;
+	size_t		paths;
+
+	dn = &game->dn;
+	paths = game->frame.cap;
+	wavefront_kernel(game, DN_INIT, "denoise_init_kernel", 6);
+	wavefront_kernel(game, DN_PASS, "denoise_kernel", 5);
+	wavefront_kernel(game, DN_FINAL, "denoise_final_kernel", 2);
+	dn->albedo = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	dn->normal = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	dn->depth = wavefront_buffer(game, sizeof(cl_float) * paths, NULL);
+	dn->pass[0] = wavefront_buffer(game, sizeof(cl_float4) * paths, NULL);
+	dn->pass[1] = wavefront_buffer(game, sizeof(cl_float4) * paths, NULL);
+	dn->result = -1;
+	wavefront_arg(game, WF_SHADE, WF_ARG + 15, &dn->albedo);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 16, &dn->normal);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 17, &dn->depth);
+	wavefront_arg(game, DN_INIT, 1, &dn->albedo);
+	wavefront_arg(game, DN_INIT, 2, &game->wf.moment);
+	wavefront_arg(game, DN_INIT, 3, &game->wf.spp);
+	wavefront_arg(game, DN_INIT, 5, &dn->pass[0]);
+	wavefront_arg(game, DN_PASS, 2, &dn->normal);
+	wavefront_arg(game, DN_PASS, 3, &dn->depth);
+	wavefront_arg(game, DN_FINAL, 1, &dn->albedo);
+}
+
+/*
+** Runs on the shown frame before post_run, which then reads the denoised
+** image instead of the accumulation. The passes look 1, 2, 4, 8 and 16
+** pixels apart.
+*/
+
+void		denoise_run(t_game *game)
+{
+	t_denoise	*dn;
+	int			i;
+
+	dn = &game->dn;
+	dn->result = -1;
+	if (!game->gpu.camera[game->cam_num].denoise || game->keys.heat
+	|| game->gpu.camera[game->cam_num].stereo)
+		return ;
+	wavefront_arg(game, DN_INIT, 0, &game->cl_info->progs[0].krls[0].args[2]);
+	denoise_exec(game, DN_INIT, 4, game->gpu.samples);
+	i = -1;
+	while (++i < DN_PASSES)
+	{
+		wavefront_arg(game, DN_PASS, 0, &dn->pass[i & 1]);
+		wavefront_arg(game, DN_PASS, 1, &dn->pass[!(i & 1)]);
+		denoise_exec(game, DN_PASS, 4, 1 << i);
+	}
+	dn->result = DN_PASSES & 1;
+	wavefront_arg(game, DN_FINAL, 0, &dn->pass[dn->result]);
+	denoise_exec(game, DN_FINAL, -1, 0);
+}
+
+/*
+** Linear image of the bucket in flight: the denoised one when the filter
+** ran, the accumulation otherwise.
+*/
+
+void		denoise_read(t_game *game, cl_float3 *pixels)
+{
+	int		size;
+	int		i;
+
+	size = game->frame.tw * game->frame.th;
+	if (game->dn.result >= 0)
+	{
+		game->cl_info->ret = cl_read(game->cl_info,
+		game->dn.pass[game->dn.result], sizeof(cl_float3) * size, pixels);
+		return ;
+	}
+	game->cl_info->ret = cl_read(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[2],
+	sizeof(cl_float3) * size, pixels);
+	i = -1;
+	while (++i < size)
+	{
+		pixels[i].x /= game->gpu.samples;
+		pixels[i].y /= game->gpu.samples;
+		pixels[i].z /= game->gpu.samples;
+	}
+}
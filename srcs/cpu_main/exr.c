@@ -0,0 +1,120 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   exr.c                                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 10:12:31 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 12:20:45 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Minimal single part, scanline, uncompressed OpenEXR writer. The image is
+** stored as 32 bit float B, G, R channels (sorted by name as the format
+** requires) so linear radiance above 1.0 survives without clamping.
+*/
+
+static void	exr_attr(int fd, char *name, char *type, int size)
+{
+	write(fd, name, ft_strlen(name) + 1);
+	write(fd, type, ft_strlen(type) + 1);
+	write(fd, &size, sizeof(int));
+}
+
+static void	exr_channels(int fd)
+{
+	char	*names;
+	int		i;
+	int		chan[4];
+
+	names = "BGR";
+	write(fd, "\x76\x2f\x31\x01\x02\x00\x00\x00", 8);
+	exr_attr(fd, "channels", "chlist", 3 * 18 + 1);
+	chan[0] = 2;
+	chan[1] = 0;
+	chan[2] = 1;
+	chan[3] = 1;
+	i = -1;
+	while (++i < 3)
+	{
+		write(fd, names + i, 1);
+		write(fd, "", 1);
+		write(fd, chan, sizeof(chan));
+	}
+	write(fd, "", 1);
+}
+
+static void	exr_header(int fd, int w, int h)
+{
+	int		box[4];
+	float	v[3];
+
+	exr_channels(fd);
+	exr_attr(fd, "compression", "compression", 1);
+	write(fd, "", 1);
+	ft_bzero(box, sizeof(box));
+	box[2] = w - 1;
+	box[3] = h - 1;
+	exr_attr(fd, "dataWindow", "box2i", sizeof(box));
+	write(fd, box, sizeof(box));
+	exr_attr(fd, "displayWindow", "box2i", sizeof(box));
+	write(fd, box, sizeof(box));
+	exr_attr(fd, "lineOrder", "lineOrder", 1);
+	write(fd, "", 1);
+	ft_bzero(v, sizeof(v));
+	v[0] = 1.f;
+	exr_attr(fd, "pixelAspectRatio", "float", sizeof(float));
+	write(fd, v, sizeof(float));
+	exr_attr(fd, "screenWindowCenter", "v2f", sizeof(float) * 2);
+	write(fd, v + 1, sizeof(float) * 2);
+	exr_attr(fd, "screenWindowWidth", "float", sizeof(float));
+	write(fd, v, sizeof(float));
+	write(fd, "", 1);
+}
+
+static void	exr_line(int fd, int y, cl_float3 *line, int w)
+{
+	int		x;
+	int		size;
+	float	*row;
+
+	size = w * 3 * sizeof(float);
+	row = malloc_exit(size);
+	x = -1;
+	while (++x < w)
+	{
+		row[x] = line[x].z;
+		row[w + x] = line[x].y;
+		row[2 * w + x] = line[x].x;
+	}
+	write(fd, &y, sizeof(int));
+	write(fd, &size, sizeof(int));
+	write(fd, row, size);
+	free(row);
+}
+
+void		save_exr(char *path, cl_float3 *pixels, int w, int h)
+{
+	int			fd;
+	int			i;
+	uint64_t	offset;
+
+	if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+		terminate(path);
+	exr_header(fd, w, h);
+	offset = lseek(fd, 0, SEEK_CUR) + sizeof(uint64_t) * h;
+	i = -1;
+	while (++i < h)
+	{
+		write(fd, &offset, sizeof(uint64_t));
+		offset += 2 * sizeof(int) + w * 3 * sizeof(float);
+	}
+	i = -1;
+	while (++i < h)
+		exr_line(fd, i, pixels + (size_t)i * w, w);
+	close(fd);
+}
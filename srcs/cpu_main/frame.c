@@ -0,0 +1,103 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   frame.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 11:14:32 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 14:05:12 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** A tile of 0 keeps the whole image in one bucket, which is how the
+** window renders.
+*/
+
+void	frame_init(t_game *game, int w, int h, int tile)
+{
+	t_frame	*f;
+
+	f = &game->frame;
+	f->w = w;
+	f->h = h;
+	f->pw = w;
+	f->ph = h;
+	f->scale = 1;
+	f->tile = tile > 0 ? tile : w + h;
+	f->cap = (size_t)(f->tile < w ? f->tile : w) * (f->tile < h ? f->tile : h);
+	frame_tile(game, 0);
+}
+
+/*
+** Moves the bucket in flight to the i-th one in scanline order, returns 0
+** past the last one.
+*/
+
+int		frame_tile(t_game *game, int i)
+{
+	t_frame	*f;
+	int		cols;
+
+	f = &game->frame;
+	cols = (f->w + f->tile - 1) / f->tile;
+	if (i >= cols * ((f->h + f->tile - 1) / f->tile))
+		return (0);
+	f->x = i % cols * f->tile;
+	f->y = i / cols * f->tile;
+	f->tw = f->w - f->x < f->tile ? f->w - f->x : f->tile;
+	f->th = f->h - f->y < f->tile ? f->h - f->y : f->tile;
+	f->ow = f->scale > 1 ? f->pw : f->tw;
+	f->oh = f->scale > 1 ? f->ph : f->th;
+	return (1);
+}
+
+/*
+** Only for a single bucket: traces the image at 1/scale of its size, the
+** output stays pw by ph. A scale of 1 puts it back.
+*/
+
+void	frame_scale(t_game *game, int scale)
+{
+	t_frame	*f;
+
+	f = &game->frame;
+	f->scale = scale;
+	f->w = (f->pw + scale - 1) / scale;
+	f->h = (f->ph + scale - 1) / scale;
+	f->tile = f->w + f->h;
+	frame_tile(game, 0);
+}
+
+/*
+** Streams the pixels of the bucket into its place on the surface, the
+** window or the image headless mode saves.
+*/
+
+void	frame_present(t_game *game, cl_int *tile)
+{
+	t_frame	*f;
+	int		y;
+
+	f = &game->frame;
+	y = -1;
+	while (++y < f->oh)
+		ft_memcpy((char *)game->sdl.surface->pixels + (size_t)(f->y + y)
+		* game->sdl.surface->pitch + f->x * sizeof(cl_int),
+		tile + (size_t)y * f->ow, sizeof(cl_int) * f->ow);
+}
+
+void	frame_store(t_game *game, cl_float3 *image, cl_float3 *tile)
+{
+	t_frame	*f;
+	int		y;
+
+	f = &game->frame;
+	y = -1;
+	while (++y < f->th)
+		ft_memcpy(image + (size_t)(f->y + y) * f->w + f->x,
+		tile + (size_t)y * f->tw, sizeof(cl_float3) * f->tw);
+}
@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   headless.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 10:12:31 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:52:16 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	headless_save(t_game *game, t_headless *opt, cl_float3 *image)
+{
+	if (image)
+		save_exr(opt->out, image, game->frame.w, game->frame.h);
+	else if (IMG_SavePNG(game->sdl.surface, opt->out))
+		terminate("Could not save the image");
+	if (!opt->cpu)
+		cl_krl_mem_release_all(game->cl_info,
+		&game->cl_info->progs[0].krls[0]);
+}
+
+/*
+** Sets up rendering without a window: no GUI, audio or network, the frame
+** only lives in an offscreen surface of the size of the image. The native
+** backend needs no OpenCL at all.
+*/
+
+void		headless_setup(t_game *game, t_gui *gui, int cpu)
+{
+	game->headless = 1;
+	if (!(game->sdl.surface = SDL_CreateRGBSurface(0, game->frame.w,
+	game->frame.h, 32, 0, 0, 0, 0)))
+		terminate("Could not create the output surface");
+	set_const(game, gui);
+	if (!cpu)
+		opencl_init(game);
+}
+
+static void	headless_scene(t_game *game, t_gui *gui, t_headless *opt)
+{
+	headless_setup(game, gui, opt->cpu);
+	if (opt->cpu)
+		native_init(game, opt->scene, opt->threads);
+	else
+		opencl(game, opt->scene);
+	game->keys.r = 1;
+	game->gpu.camera[game->cam_num].denoise |= opt->denoise;
+}
+
+/*
+** Every bucket is rendered to the full sample count on its own, then its
+** pixels go into the image and the accumulation starts over for the next.
+*/
+
+void		headless_tile(t_game *game, t_headless *opt, cl_float3 *image)
+{
+	cl_float3	*pixels;
+
+	if (opt->cpu)
+	{
+		native_tile(game, opt->spp, image);
+		return ;
+	}
+	game->gpu.samples = 0;
+	game->cl_info->ret = cl_write(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[2],
+	sizeof(cl_float3) * game->frame.cap, game->gpu.vec_temp);
+	while (game->gpu.samples < opt->spp)
+		ft_run_kernel(game, &game->cl_info->progs[0].krls[0]);
+	ft_display(game);
+	present_flush(game);
+	if (!image)
+		return ;
+	pixels = malloc_exit(sizeof(cl_float3) * game->frame.cap);
+	denoise_read(game, pixels);
+	frame_store(game, image, pixels);
+	free(pixels);
+}
+
+int			headless_main(int argc, char **argv)
+{
+	t_game		game;
+	t_gui		gui;
+	t_headless	opt;
+	cl_float3	*image;
+	int			i;
+
+	if (!ft_strcmp(argv[1], "--bench"))
+		return (bench_main(argc, argv));
+	if (!ft_strcmp(argv[1], "--raybench"))
+		return (raybench_main(argc, argv));
+	if (ft_strcmp(argv[1], "--headless"))
+		return (check_main(argc, argv));
+	headless_args(&opt, argc, argv);
+	frame_init(&game, opt.w, opt.h, opt.tile);
+	headless_scene(&game, &gui, &opt);
+	image = opt.exr ? malloc_exit(sizeof(cl_float3) * opt.w * opt.h) : NULL;
+	i = -1;
+	while (frame_tile(&game, ++i))
+		headless_tile(&game, &opt, image);
+	headless_save(&game, &opt, image);
+	SDL_FreeSurface(game.sdl.surface);
+	free(image);
+	return (0);
+}
@@ -0,0 +1,111 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   headless_args.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 11:31:06 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:52:16 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void		headless_usage(void)
+{
+	terminate("usage: ./RT --headless scene.json --spp N "
+	"--out image.png|image.exr\n"
+	"       [--size W H] [--tile N] [--denoise] [--cpu [--threads N]]\n"
+	"       ./RT --bench [--spp N] [--out results.json] [scene.json ...]\n"
+	"       ./RT --raybench scene.json [--threads N] [--runs N]\n"
+	"       ./RT --mischeck|--splitcheck scene.json [--spp N] "
+	"[--threads N]");
+}
+
+static void	headless_defaults(t_headless *opt)
+{
+	opt->scene = NULL;
+	opt->out = NULL;
+	opt->spp = SAMPLES;
+	opt->denoise = 0;
+	opt->w = WIN_W;
+	opt->h = WIN_H;
+	opt->tile = 0;
+	opt->cpu = 0;
+	opt->threads = 0;
+}
+
+/*
+** Options of the image itself, returns the last argument they took or -1.
+*/
+
+static int	headless_image(t_headless *opt, int argc, char **argv, int i)
+{
+	if (!ft_strcmp(argv[i], "--size") && i + 2 < argc)
+	{
+		opt->w = ft_atoi(argv[i + 1]);
+		opt->h = ft_atoi(argv[i + 2]);
+		return (i + 2);
+	}
+	if (!ft_strcmp(argv[i], "--tile") && i + 1 < argc)
+	{
+		opt->tile = ft_atoi(argv[i + 1]);
+		return (i + 1);
+	}
+	if (!ft_strcmp(argv[i], "--denoise"))
+	{
+		opt->denoise = 1;
+		return (i);
+	}
+	return (-1);
+}
+
+/*
+** --cpu renders on the native backend, with a thread per core unless
+** --threads says otherwise.
+*/
+
+static int	headless_backend(t_headless *opt, int argc, char **argv, int i)
+{
+	if (!ft_strcmp(argv[i], "--cpu"))
+	{
+		opt->cpu = 1;
+		return (i);
+	}
+	if (!ft_strcmp(argv[i], "--threads") && i + 1 < argc)
+	{
+		opt->threads = ft_atoi(argv[i + 1]);
+		return (i + 1);
+	}
+	return (-1);
+}
+
+void		headless_args(t_headless *opt, int argc, char **argv)
+{
+	int		i;
+	int		last;
+	size_t	len;
+
+	headless_defaults(opt);
+	i = 1;
+	while (++i < argc)
+	{
+		if (!ft_strcmp(argv[i], "--spp") && i + 1 < argc)
+			opt->spp = ft_atoi(argv[++i]);
+		else if (!ft_strcmp(argv[i], "--out") && i + 1 < argc)
+			opt->out = argv[++i];
+		else if ((last = headless_image(opt, argc, argv, i)) >= 0
+		|| (last = headless_backend(opt, argc, argv, i)) >= 0)
+			i = last;
+		else if (argv[i][0] != '-' && !opt->scene)
+			opt->scene = argv[i];
+		else
+			headless_usage();
+	}
+	if (!opt->scene || !opt->out || opt->spp <= 0 || opt->w <= 0
+	|| opt->h <= 0 || opt->tile < 0 || opt->threads < 0)
+		headless_usage();
+	len = ft_strlen(opt->out);
+	opt->exr = len > 4 && !ft_strcmp(opt->out + len - 4, ".exr");
+}
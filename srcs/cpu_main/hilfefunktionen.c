@@ -6,26 +6,13 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/23 14:51:09 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 14:56:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/22 11:20:44 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 #include "errno.h"
 
-cl_ulong	*get_random(cl_ulong *random)
-{
-	int i;
-
-	i = -1;
-	if (!(random = ft_memalloc(sizeof(cl_ulong) * (int)WIN_H * (int)WIN_W)))
-		ft_exit(0);
-	srand(time(NULL));
-	while (++i < WIN_H * WIN_W)
-		random[i] = rand() | (cl_ulong)rand() << 32;
-	return (random);
-}
-
 int			compare_in_texture_dict(t_game *game, char *texture_name)
 {
 	int i;
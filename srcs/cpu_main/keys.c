@@ -6,12 +6,31 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/18 18:10:38 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 19:07:49 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/27 23:41:20 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
+/*
+** h shows the samples every pixel took instead of the image, j switches
+** adaptive sampling and starts the accumulation over.
+*/
+
+static void	key_view(t_game *game)
+{
+	if (game->ev.key.keysym.sym == SDLK_h)
+	{
+		game->keys.heat = !game->keys.heat;
+		game->flag = 1;
+	}
+	else if (game->ev.key.keysym.sym == SDLK_j)
+	{
+		game->keys.adaptive = !game->keys.adaptive;
+		game->flag = 1;
+	}
+}
+
 static void	key_switch(t_game *game)
 {
 	if (game->keys.ed_box)
@@ -36,6 +55,8 @@ static void	key_switch(t_game *game)
 		show_hide(game, g_gui(0, 0));
 	else if (game->ev.key.keysym.sym == SDLK_r)
 		game->keys.r = !game->keys.r;
+	else
+		key_view(game);
 }
 
 static void	key_down(t_game *game)
@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   lights.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/25 19:05:41 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/25 19:05:41 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Emissive spheres, triangles and planes are sampled for direct light.
+** An infinite plane has no finite power, it is weighed like a patch of
+** LIGHT_PLANE_AREA.
+*/
+
+static float	light_power(t_obj *obj)
+{
+	float	lum;
+
+	lum = 0.2126f * obj->emission.s[0] + 0.7152f * obj->emission.s[1]
+	+ 0.0722f * obj->emission.s[2];
+	if (lum <= 0.f || !obj->is_visible)
+		return (0.f);
+	if (obj->type == SPHERE)
+		return (lum * 4.f * M_PI * obj->radius * obj->radius);
+	if (obj->type == PLANE)
+		return (lum * LIGHT_PLANE_AREA);
+	if (obj->type == TRIANGLE)
+		return (lum * 0.5f * vec_len(cross(vector_diff(obj->vertices[1],
+		obj->vertices[0]), vector_diff(obj->vertices[2], obj->vertices[0]))));
+	return (0.f);
+}
+
+static float	lights_cdf(t_game *game)
+{
+	t_light	*lights;
+	float	total;
+	float	power;
+	int		i;
+
+	if (game->gpu.lights_cap < game->obj_cap)
+	{
+		game->gpu.lights_cap = game->obj_cap;
+		if (!(game->gpu.lights = realloc(game->gpu.lights,
+		sizeof(t_light) * game->gpu.lights_cap)))
+			terminate("Malloc ne ok\n");
+	}
+	lights = game->gpu.lights;
+	total = 0.f;
+	game->gpu.lights_num = 0;
+	i = -1;
+	while (++i < (int)game->obj_quantity)
+		if ((power = light_power(&game->gpu.objects[i])) > 0.f)
+		{
+			total += power;
+			lights[game->gpu.lights_num].id = i;
+			lights[game->gpu.lights_num++].cdf = total;
+		}
+	return (total);
+}
+
+/*
+** Rebuilds the list after edits. Objects whose share changed are marked
+** dirty, so their geometry record is packed again with the new share.
+*/
+
+void			lights_build(t_game *game)
+{
+	t_light	*lights;
+	float	total;
+	float	pick;
+	float	prev;
+	int		i;
+
+	total = lights_cdf(game);
+	lights = game->gpu.lights;
+	prev = 0.f;
+	i = -1;
+	while (++i < (int)game->obj_quantity)
+	{
+		pick = 0.f;
+		if (lights != game->gpu.lights + game->gpu.lights_num
+		&& lights->id == i)
+		{
+			pick = (lights->cdf - prev) / total;
+			prev = lights->cdf;
+			(lights++)->cdf /= total;
+		}
+		if (game->gpu.objects[i].light_pick != pick)
+			obj_dirty(game, i, i);
+		game->gpu.objects[i].light_pick = pick;
+	}
+}
+
+void			lights_write(t_game *game)
+{
+	if (!game->gpu.lights_num)
+		return ;
+	game->cl_info->ret = cl_write(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[22],
+	sizeof(t_light) * game->gpu.lights_num, game->gpu.lights);
+}
+
+void			lights_init_args(t_game *game)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	cl_krl_init_arg(krl, 22, sizeof(t_light) * game->obj_cap,
+	game->gpu.lights);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 22,
+	CL_MEM_READ_ONLY);
+}
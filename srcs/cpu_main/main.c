@@ -6,7 +6,7 @@
 /*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/05/22 15:34:45 by sdurgan           #+#    #+#             */
-/*   Updated: 2019/12/18 15:47:49 by lminta           ###   ########.fr       */
+/*   Updated: 2019/12/27 12:20:45 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -81,9 +81,11 @@ int			main(int argc, char **argv)
 	t_game	game;
 	t_gui	gui;
 
-	gui.game = &game;
+	if (argc > 1 && !ft_strncmp(argv[1], "--", 2))
+		return (headless_main(argc, argv));
+	game.headless = 0;
+	frame_init(&game, WIN_W, WIN_H, 0);
 	cam_shot("./textures/sviborg_you.jpg");
-	gui.main_screen = 0;
 	ft_init_window(&game.sdl, WIN_W, WIN_H);
 	set_const(&game, &gui);
 	set_icon(&gui, "gui/res/icon.png");
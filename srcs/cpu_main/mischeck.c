@@ -0,0 +1,84 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mischeck.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 23:24:31 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:52:16 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Mean radiance of the linear image, summed in double so the pixels of
+** a large image do not drown each other.
+*/
+
+static void	check_mean(t_game *game, cl_float3 *image, double *mean)
+{
+	int		size;
+	int		i;
+
+	size = game->frame.w * game->frame.h;
+	mean[0] = 0.0;
+	mean[1] = 0.0;
+	mean[2] = 0.0;
+	i = -1;
+	while (++i < size)
+	{
+		mean[0] += image[i].x;
+		mean[1] += image[i].y;
+		mean[2] += image[i].z;
+	}
+	mean[0] /= size;
+	mean[1] /= size;
+	mean[2] /= size;
+}
+
+/*
+** A bsdf sample that hits a light after the last bounce is never traced,
+** while the light sample of the last bounce still finds it. The second
+** pass goes one bounce further so both cover the same paths.
+*/
+
+static void	mischeck_passes(t_game *game, t_check *check, cl_float3 *image)
+{
+	if (game->max_bounces >= MAX_BOUNCES)
+		game->max_bounces = MAX_BOUNCES - 1;
+	game->keys.nee = 1;
+	native_tile(game, check->spp, image);
+	check_mean(game, image, check->mean[0]);
+	game->keys.nee = 0;
+	game->max_bounces++;
+	native_tile(game, check->spp, image);
+	check_mean(game, image, check->mean[1]);
+}
+
+/*
+** Light samples weighted by MIS against the bsdf samples that hit lights
+** have to add up to the same image as bsdf samples alone. The scene is
+** traced on the native backend, in the full render mode and without
+** adaptive sampling or the denoiser, which would blur the comparison.
+*/
+
+int			mischeck_main(t_check *check)
+{
+	t_game		game;
+	t_gui		gui;
+	cl_float3	*image;
+
+	frame_init(&game, CHECK_W, CHECK_H, 0);
+	headless_setup(&game, &gui, 1);
+	native_init(&game, check->scene, check->threads);
+	game.keys.r = 1;
+	game.keys.adaptive = 0;
+	game.gpu.camera[game.cam_num].denoise = 0;
+	image = malloc_exit(sizeof(cl_float3) * CHECK_W * CHECK_H);
+	mischeck_passes(&game, check, image);
+	free(image);
+	SDL_FreeSurface(game.sdl.surface);
+	return (check_report(check, "light sampling", "bsdf only"));
+}
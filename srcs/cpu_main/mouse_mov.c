@@ -6,21 +6,21 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/10 18:06:44 by jblack-b          #+#    #+#             */
-/*   Updated: 2019/12/10 18:08:42 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/27 12:20:45 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
-void		reconfigure_camera(t_cam *camera)
+void		reconfigure_camera(t_game *game, t_cam *camera)
 {
 	float		x_fov;
 	float		y_fov;
+	float		aspect;
 
-	x_fov = (float)WIN_W / (float)WIN_H > 1 ? camera->fov / 2 :
-	camera->fov / 2 * (float)WIN_W / (float)WIN_H;
-	y_fov = (float)WIN_H / (float)WIN_W > 1 ? (camera->fov / 2) :
-	(camera->fov / 2) * ((float)WIN_H / (float)WIN_W);
+	aspect = (float)game->frame.w / (float)game->frame.h;
+	x_fov = aspect > 1 ? camera->fov / 2 : camera->fov / 2 * aspect;
+	y_fov = 1 / aspect > 1 ? (camera->fov / 2) : (camera->fov / 2) / aspect;
 	camera->border_y = vector_diff(
 	rotate(camera->normal, camera->direction, x_fov),
 	rotate(camera->normal, camera->direction, -x_fov));
@@ -0,0 +1,102 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:20:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** The kernels are built apart from the host, a struct the two lay out
+** differently would be read as garbage.
+*/
+
+static void	native_layout_check(void)
+{
+	size_t	size[NATIVE_TYPES];
+	int		i;
+
+	size[NATIVE_GEOM] = sizeof(t_geom);
+	size[NATIVE_SURFACE] = sizeof(t_surface);
+	size[NATIVE_TXTURE] = sizeof(t_txture);
+	size[NATIVE_BVH_NODE] = sizeof(t_bvh_node);
+	size[NATIVE_TRI] = sizeof(t_tri);
+	size[NATIVE_LIGHT] = sizeof(t_light);
+	size[NATIVE_CAM] = sizeof(t_cam);
+	size[NATIVE_WAVE] = sizeof(t_wave);
+	i = -1;
+	while (++i < NATIVE_TYPES)
+		if (native_layout(i) != size[i])
+			terminate("native kernels and host disagree on a struct\n");
+}
+
+/*
+** The image atlas_upload hands the device, kept on the host.
+*/
+
+static void	native_atlas(t_game *game)
+{
+	cl_int	*img;
+	size_t	size;
+
+	game->atlas.max_w = 0;
+	game->atlas.max_h = 0;
+	atlas_pack(game);
+	size = sizeof(cl_int) * game->atlas.img_w * game->atlas.img_h;
+	img = malloc_exit(size ? size : sizeof(cl_int));
+	ft_bzero(img, size);
+	atlas_blit(&game->atlas, game->textures, game->textures_num, img);
+	atlas_blit(&game->atlas, game->normals, game->normals_num, img);
+	game->native.atlas.pixels = img;
+	game->native.atlas.w = game->atlas.img_w;
+	game->native.atlas.h = game->atlas.img_h;
+}
+
+/*
+** The packet kernels take the arguments of the kernels they stand in for,
+** they run from the widest build the processor supports and are used
+** when that build has more than one lane.
+*/
+
+static void	native_packets(t_native *nv)
+{
+	nv->isa = native_isa();
+	nv->packet = native_lanes(nv->isa);
+	nv->krl[PK_EXTEND] = nv->krl[WF_EXTEND];
+	nv->krl[PK_EXTEND].krl = PK_EXTEND;
+	nv->krl[PK_EXTEND].isa = nv->isa;
+	nv->krl[PK_CONNECT] = nv->krl[WF_CONNECT];
+	nv->krl[PK_CONNECT].krl = PK_CONNECT;
+	nv->krl[PK_CONNECT].isa = nv->isa;
+}
+
+/*
+** Loads the scene like opencl() without uploading anything, the kernels
+** read the arrays the parser built. The path state is sized for the
+** views of the first camera, which headless renders never change.
+*/
+
+void		native_init(t_game *game, char *scene, int threads)
+{
+	native_layout_check();
+	ft_bzero(&game->native, sizeof(t_native));
+	ft_bzero(&game->gpu, sizeof(t_gpu));
+	game->cl_info = NULL;
+	game->cam_num = 0;
+	game->obj_quantity = 0;
+	read_scene(scene, game);
+	lights_build(game);
+	obj_pack(game, 0, game->obj_quantity - 1);
+	native_atlas(game);
+	game->native.views = game->gpu.camera[0].stereo == 1 ? 2 : 1;
+	native_state(game);
+	native_bind(game);
+	native_packets(&game->native);
+	pool_init(&game->native.pool, threads);
+}
@@ -0,0 +1,149 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_args.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 21:10:00 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Indices follow wavefront_args.c, scene arrays below WF_ARG and the
+** t_wave block at WF_WAVE.
+*/
+
+static void	native_args_scene(t_game *game, t_native *nv)
+{
+	void	**arg;
+	int		krl;
+
+	krl = WF_GENERATE - 1;
+	while (++krl <= WF_ADAPT)
+	{
+		arg = nv->krl[krl].arg;
+		arg[0] = game->gpu.geoms;
+		arg[1] = game->gpu.surfaces;
+		arg[2] = game->textures;
+		arg[3] = game->normals;
+		arg[4] = game->bvh.nodes;
+		arg[5] = game->bvh.index;
+		arg[6] = game->mesh.data;
+		arg[7] = game->mesh.tris;
+		arg[8] = game->mesh.bvh.nodes;
+		arg[9] = &nv->atlas;
+		arg[10] = game->gpu.lights;
+		arg[WF_WAVE] = &nv->wave;
+	}
+}
+
+static void	native_args_generate(t_native *nv)
+{
+	void	**arg;
+
+	arg = nv->krl[WF_GENERATE].arg + WF_ARG;
+	arg[0] = nv->ray_o;
+	arg[1] = nv->ray_d;
+	arg[2] = nv->throughput;
+	arg[3] = nv->queue[0];
+	arg[4] = nv->counters;
+	arg[5] = nv->active;
+	arg[6] = nv->cams;
+	arg = nv->krl[WF_EXTEND].arg + WF_ARG;
+	arg[0] = nv->ray_o;
+	arg[1] = nv->ray_d;
+	arg[2] = nv->hit_t;
+	arg[3] = nv->hit_id;
+	arg[4] = nv->hit_prim;
+	arg[6] = nv->counters;
+}
+
+static void	native_args_shade(t_native *nv)
+{
+	void	**arg;
+
+	arg = nv->krl[WF_SHADE].arg + WF_ARG;
+	arg[0] = nv->ray_o;
+	arg[1] = nv->ray_d;
+	arg[2] = nv->throughput;
+	arg[3] = nv->hit_t;
+	arg[4] = nv->hit_id;
+	arg[5] = nv->hit_prim;
+	arg[8] = nv->counters;
+	arg[9] = nv->radiance[0];
+	arg[10] = nv->sh_point;
+	arg[11] = nv->sh_dir;
+	arg[12] = nv->sh_weight;
+	arg[13] = nv->shadow_queue;
+	arg[14] = nv->ray_pdf;
+	arg[15] = nv->albedo;
+	arg[16] = nv->normal;
+	arg[17] = nv->depth;
+	arg[18] = nv->radiance[1];
+}
+
+static void	native_args_resolve(t_game *game, t_native *nv)
+{
+	void	**arg;
+
+	arg = nv->krl[WF_CONNECT].arg + WF_ARG;
+	arg[0] = nv->counters;
+	arg[1] = nv->radiance[0];
+	arg[2] = nv->sh_point;
+	arg[3] = nv->sh_dir;
+	arg[4] = nv->sh_weight;
+	arg[5] = nv->shadow_queue;
+	arg[6] = nv->radiance[1];
+	arg = nv->krl[WF_ADAPT].arg + WF_ARG;
+	arg[0] = nv->radiance[0];
+	arg[1] = nv->accum;
+	arg[2] = nv->moment;
+	arg[3] = nv->spp;
+	arg[4] = nv->active;
+	arg[5] = nv->counters;
+	arg = nv->krl[0].arg;
+	arg[2] = nv->accum;
+	arg[6] = &game->gpu.samples;
+	arg[7] = &nv->wave.camera;
+	arg[10] = nv->eye;
+	arg[16] = nv->radiance[0];
+	arg[17] = nv->radiance[1];
+}
+
+/*
+** Everything but the ping-ponged queues and buffers and the scalars the
+** passes pick per launch, see native_run.c and native_post.c.
+*/
+
+void		native_bind(t_game *game)
+{
+	t_native	*nv;
+	int			krl;
+
+	nv = &game->native;
+	krl = -1;
+	while (++krl < KERNELS)
+		nv->krl[krl].krl = krl;
+	native_args_scene(game, nv);
+	native_args_generate(nv);
+	native_args_shade(nv);
+	native_args_resolve(game, nv);
+	nv->krl[DN_INIT].arg[0] = nv->accum;
+	nv->krl[DN_INIT].arg[1] = nv->albedo;
+	nv->krl[DN_INIT].arg[2] = nv->moment;
+	nv->krl[DN_INIT].arg[3] = nv->spp;
+	nv->krl[DN_INIT].arg[4] = &game->gpu.samples;
+	nv->krl[DN_INIT].arg[5] = nv->pass[0];
+	nv->krl[DN_PASS].arg[2] = nv->normal;
+	nv->krl[DN_PASS].arg[3] = nv->depth;
+	nv->krl[DN_FINAL].arg[1] = nv->albedo;
+	nv->krl[POST_PACK].arg[1] = nv->eye;
+	nv->krl[POST_PACK].arg[2] = nv->spp;
+	nv->krl[POST_PACK].arg[3] = nv->lut;
+	nv->krl[POST_PACK].arg[4] = nv->out;
+	nv->krl[POST_PACK].arg[6] = &game->gpu.samples;
+}
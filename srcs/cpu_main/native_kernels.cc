@@ -0,0 +1,144 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_kernels.cc                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:20:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "cl_native.hl"
+
+/*
+** The kernels of main.cl built for the host. Arguments come as the host
+** set them, see native.h, and an item is one work item of the launch.
+*/
+
+thread_local cl_host_item	g_cl_item;
+
+static void	native_wave(const t_native_launch *l)
+{
+	if (l->krl == WF_GENERATE)
+		generate_kernel(SCENE, F3(12), F3(13), F3(14), I1(15), I1(16),
+			I1(17), BUF(t_cam *, 18));
+	else if (l->krl == WF_EXTEND)
+		extend_kernel(SCENE, F3(12), F3(13), F1(14), I1(15), I1(16),
+			I1(17), I1(18));
+	else if (l->krl == WF_SHADE)
+		shade_kernel(SCENE, F3(12), F3(13), F3(14), F1(15), I1(16), I1(17),
+			I1(18), I1(19), I1(20), F3(21), F3(22), F3(23), F3(24), I1(25),
+			F1(26), F3(27), F3(28), F1(29), F3(30));
+	else if (l->krl == WF_CONNECT)
+		connect_kernel(SCENE, I1(12), F3(13), F3(14), F3(15), F3(16),
+			I1(17), F3(18));
+	else if (l->krl == WF_ADAPT)
+		adapt_kernel(SCENE, F3(12), F3(13), F1(14), I1(15), I1(16), I1(17));
+}
+
+/*
+** The packet kernels run from the unit of the instruction set native_isa
+** picked, see native_packet.cc. The x86 ones are only linked in when the
+** Makefile built them.
+*/
+
+static void	native_packet(const t_native_launch *l)
+{
+#ifdef NATIVE_X86
+	if (l->isa == NATIVE_AVX2)
+		native_packet_avx2(l);
+	else if (l->isa == NATIVE_SSE42)
+		native_packet_sse42(l);
+	else
+#endif
+		native_packet_base(l);
+}
+
+/*
+** The resolve only reads the buffers and scalars it uses, the rest of
+** render_kernel's arguments may stay unset.
+*/
+
+static void	native_pixel(const t_native_launch *l)
+{
+	if (l->krl == 0)
+		render_kernel(I1(0), BUF(t_geom *, 1), F3(2), 0, 0, 0, VAL(int, 6),
+			VAL(t_cam, 7), 0, 0, F3(10), 0, 0, 0, 0, 0, F3(16), F3(17), 0, 0,
+			0, 0, 0);
+	else if (l->krl == DN_INIT)
+		denoise_init_kernel(F3(0), F3(1), F1(2), I1(3), VAL(int, 4),
+			BUF(float4 *, 5));
+	else if (l->krl == DN_PASS)
+		denoise_kernel(BUF(float4 *, 0), BUF(float4 *, 1), F3(2), F1(3),
+			VAL(int, 4));
+	else if (l->krl == DN_FINAL)
+		denoise_final_kernel(BUF(float4 *, 0), F3(1));
+	else if (l->krl == POST_PACK)
+		post_kernel(F3(0), F3(1), I1(2), BUF(const int *, 3), I1(4),
+			VAL(float, 5), VAL(int, 6), VAL(int, 7));
+}
+
+extern "C" void	native_item(const t_native_launch *l, size_t item)
+{
+	g_cl_item.size[0] = l->size[0];
+	g_cl_item.size[1] = l->size[1];
+	g_cl_item.id[0] = item % l->size[0];
+	g_cl_item.id[1] = item / l->size[0];
+	if (l->krl >= PK_EXTEND)
+		native_packet(l);
+	else if (l->krl >= WF_GENERATE && l->krl <= WF_ADAPT)
+		native_wave(l);
+	else
+		native_pixel(l);
+}
+
+/*
+** The widest packets the processor runs, asked once when the backend
+** starts. A build without the x86 units keeps the packets of the flags
+** the tree was compiled with.
+*/
+
+extern "C" int	native_isa(void)
+{
+#ifdef NATIVE_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (NATIVE_AVX2);
+	if (__builtin_cpu_supports("sse4.2"))
+		return (NATIVE_SSE42);
+#endif
+	return (NATIVE_BASE);
+}
+
+/*
+** Rays a packet kernel of isa takes per work item, 1 when its unit was
+** built without SSE and traces them one by one.
+*/
+
+extern "C" int	native_lanes(int isa)
+{
+#ifdef NATIVE_X86
+	if (isa == NATIVE_AVX2)
+		return (native_lanes_avx2());
+	if (isa == NATIVE_SSE42)
+		return (native_lanes_sse42());
+#endif
+	(void)isa;
+	return (native_lanes_base());
+}
+
+/*
+** Sizes of the structs both sides share, the host refuses to run when
+** one differs from its own.
+*/
+
+extern "C" size_t	native_layout(int type)
+{
+	const size_t	size[NATIVE_TYPES] = {sizeof(t_geom), sizeof(t_surface),
+		sizeof(t_txture), sizeof(t_bvh_node), sizeof(t_tri),
+		sizeof(t_light), sizeof(t_cam), sizeof(t_wave)};
+
+	return (type >= 0 && type < NATIVE_TYPES ? size[type] : 0);
+}
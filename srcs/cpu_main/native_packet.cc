@@ -0,0 +1,44 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_packet.cc                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/28 00:20:11 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:20:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "cl_native.hl"
+
+namespace
+{
+# include "cl_packet.hl"
+}
+
+/*
+** The packet kernels for one instruction set. The Makefile builds this
+** unit once per set with its flags and NATIVE_ISA naming it, the entry
+** points carry the name so the objects link side by side and
+** native_kernels.cc calls the one the processor runs.
+*/
+
+#define NATIVE_NAME(f, isa) NATIVE_PASTE(f, isa)
+#define NATIVE_PASTE(f, isa) f##_##isa
+
+extern "C" int	NATIVE_NAME(native_lanes, NATIVE_ISA)(void)
+{
+	return (PACKET);
+}
+
+extern "C" void	NATIVE_NAME(native_packet, NATIVE_ISA)(
+	const t_native_launch *l)
+{
+	if (l->krl == PK_EXTEND)
+		packet_extend(SCENE, F3(12), F3(13), F1(14), I1(15), I1(16),
+			I1(17), I1(18));
+	else if (l->krl == PK_CONNECT)
+		packet_connect(SCENE, I1(12), F3(13), F3(14), F3(15), F3(16),
+			I1(17), F3(18));
+}
@@ -0,0 +1,147 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_pool.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 21:10:00 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+#include <unistd.h>
+
+/*
+** Takes a tile off the front of the own range or off the back of another
+** worker's, returns 0 once the range is empty.
+*/
+
+static int	deque_take(t_deque *deque, int back, size_t *tile)
+{
+	int		took;
+
+	pthread_mutex_lock(&deque->lock);
+	took = deque->lo < deque->hi;
+	if (took && back)
+		*tile = --deque->hi;
+	else if (took)
+		*tile = deque->lo++;
+	pthread_mutex_unlock(&deque->lock);
+	return (took);
+}
+
+/*
+** Runs the own tiles first, then robs the other workers one after the
+** other until every range is empty.
+*/
+
+static void	pool_work(t_pool *pool, t_worker *self)
+{
+	t_deque	*deque;
+	size_t	tile;
+	size_t	item;
+	size_t	end;
+	int		i;
+
+	i = 0;
+	while (i < pool->num)
+	{
+		deque = &pool->worker[(self->id + i) % pool->num].deque;
+		if (!deque_take(deque, i > 0, &tile))
+		{
+			i++;
+			continue ;
+		}
+		item = tile * NATIVE_TILE;
+		end = item + NATIVE_TILE < pool->items ? item + NATIVE_TILE
+		: pool->items;
+		while (item < end)
+			native_item(pool->launch, item++);
+	}
+}
+
+static void	*pool_worker(void *arg)
+{
+	t_worker	*self;
+	t_pool		*pool;
+	int			gen;
+
+	self = arg;
+	pool = self->pool;
+	gen = 0;
+	while (1)
+	{
+		pthread_mutex_lock(&pool->lock);
+		while (pool->gen == gen)
+			pthread_cond_wait(&pool->start, &pool->lock);
+		gen = pool->gen;
+		pthread_mutex_unlock(&pool->lock);
+		pool_work(pool, self);
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->busy == 0)
+			pthread_cond_signal(&pool->done);
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return (NULL);
+}
+
+/*
+** A worker per online core unless num asks for a count, they sleep
+** between launches and live as long as the process.
+*/
+
+void		pool_init(t_pool *pool, int num)
+{
+	int		i;
+
+	pool->num = num > 0 ? num : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	pool->num += pool->num < 1;
+	pool->worker = malloc_exit(sizeof(t_worker) * pool->num);
+	pool->gen = 0;
+	pool->busy = 0;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	i = -1;
+	while (++i < pool->num)
+	{
+		pool->worker[i].pool = pool;
+		pool->worker[i].id = i;
+		pool->worker[i].deque.lo = 0;
+		pool->worker[i].deque.hi = 0;
+		pthread_mutex_init(&pool->worker[i].deque.lock, NULL);
+		if (pthread_create(&pool->worker[i].thread, NULL, pool_worker,
+		&pool->worker[i]))
+			terminate("could not start the native worker threads\n");
+	}
+}
+
+/*
+** Deals the tiles of a launch out evenly and waits for the workers, so
+** launches follow each other like on an in-order queue.
+*/
+
+void		pool_run(t_pool *pool, t_native_launch *launch)
+{
+	size_t	tiles;
+	int		i;
+
+	pool->launch = launch;
+	pool->items = launch->size[0] * launch->size[1];
+	tiles = (pool->items + NATIVE_TILE - 1) / NATIVE_TILE;
+	i = -1;
+	while (++i < pool->num)
+	{
+		pool->worker[i].deque.lo = tiles * i / pool->num;
+		pool->worker[i].deque.hi = tiles * (i + 1) / pool->num;
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->busy = pool->num;
+	pool->gen++;
+	pthread_cond_broadcast(&pool->start);
+	while (pool->busy)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,117 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_post.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 21:10:00 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** denoise_run on the pool, returns the pass holding the result or -1
+** when the camera does not ask for it.
+*/
+
+static int	native_denoise(t_game *game, t_native *nv)
+{
+	t_cam	*cam;
+	int		step;
+	int		i;
+
+	cam = &game->gpu.camera[game->cam_num];
+	if (!cam->denoise || game->keys.heat || cam->stereo)
+		return (-1);
+	native_exec(game, DN_INIT, game->frame.tw, game->frame.th);
+	nv->krl[DN_PASS].arg[4] = &step;
+	i = -1;
+	while (++i < DN_PASSES)
+	{
+		step = 1 << i;
+		nv->krl[DN_PASS].arg[0] = nv->pass[i & 1];
+		nv->krl[DN_PASS].arg[1] = nv->pass[!(i & 1)];
+		native_exec(game, DN_PASS, game->frame.tw, game->frame.th);
+	}
+	nv->krl[DN_FINAL].arg[0] = nv->pass[DN_PASSES & 1];
+	native_exec(game, DN_FINAL, game->frame.tw, game->frame.th);
+	return (DN_PASSES & 1);
+}
+
+/*
+** post_run without the motion blur, its kernel shares rows through local
+** memory the pool does not have. The bucket goes on the surface.
+*/
+
+static void	native_pack(t_game *game, t_native *nv, int result)
+{
+	t_cam	*cam;
+	cl_int	mode;
+	float	inv;
+
+	cam = &game->gpu.camera[game->cam_num];
+	mode = (cam->sepia == 1) * POST_SEPIA | (cam->cartoon == 1);
+	post_lut(nv->lut, mode);
+	mode = (mode & POST_SEPIA) | (cam->stereo == 1) * POST_STEREO
+	| (game->keys.heat != 0) * POST_HEAT;
+	inv = result >= 0 ? 1.f : 1.f / game->gpu.samples;
+	nv->krl[POST_PACK].arg[0] = result >= 0 ? (void *)nv->pass[result]
+	: (void *)nv->accum;
+	nv->krl[POST_PACK].arg[5] = &inv;
+	nv->krl[POST_PACK].arg[7] = &mode;
+	native_exec(game, POST_PACK, game->frame.tw, game->frame.th);
+	frame_present(game, nv->out);
+}
+
+/*
+** The linear image for exr, what denoise_read gives on a device. The
+** accumulation is divided in place, the next bucket starts it over.
+*/
+
+static void	native_store(t_game *game, t_native *nv, int result,
+			cl_float3 *image)
+{
+	int		size;
+	int		i;
+
+	if (result >= 0)
+	{
+		frame_store(game, image, nv->pass[result]);
+		return ;
+	}
+	size = game->frame.tw * game->frame.th;
+	i = -1;
+	while (++i < size)
+	{
+		nv->accum[i].x /= game->gpu.samples;
+		nv->accum[i].y /= game->gpu.samples;
+		nv->accum[i].z /= game->gpu.samples;
+	}
+	frame_store(game, image, nv->accum);
+}
+
+/*
+** headless_tile for the native backend: the bucket in flight is traced
+** to spp samples, presented and stored when image is there.
+*/
+
+void		native_tile(t_game *game, int spp, cl_float3 *image)
+{
+	t_native	*nv;
+	int			result;
+
+	nv = &game->native;
+	game->gpu.samples = 0;
+	while (game->gpu.samples < spp)
+	{
+		game->gpu.samples += SAMPLES;
+		native_trace(game);
+	}
+	result = native_denoise(game, nv);
+	native_pack(game, nv, result);
+	if (image)
+		native_store(game, nv, result, image);
+}
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_run.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:24:31 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void		native_exec(t_game *game, int krl, size_t w, size_t h)
+{
+	t_native_launch	*launch;
+
+	launch = &game->native.krl[krl];
+	launch->size[0] = w;
+	launch->size[1] = h;
+	pool_run(&game->native.pool, launch);
+}
+
+/*
+** The single ray kernels loop over their queue with WAVE_THREADS items,
+** the packet ones take a work item per packet of the rays queued.
+*/
+
+void		native_rays(t_game *game, int krl, int rays)
+{
+	int		packet;
+
+	packet = game->native.packet;
+	if (krl < PK_EXTEND)
+		native_exec(game, krl, WAVE_THREADS, 1);
+	else
+		native_exec(game, krl, rays > 0 ? (rays + packet - 1) / packet : 1,
+		1);
+}
+
+static void	native_bounce(t_game *game, t_native *nv)
+{
+	int		in;
+	int		extend;
+
+	in = nv->wave.bounce & 1;
+	nv->wave.q_in = in;
+	extend = nv->packet > 1 ? PK_EXTEND : WF_EXTEND;
+	nv->krl[extend].arg[WF_ARG + 5] = nv->queue[in];
+	nv->krl[WF_SHADE].arg[WF_ARG + 6] = nv->queue[in];
+	nv->krl[WF_SHADE].arg[WF_ARG + 7] = nv->queue[!in];
+	native_rays(game, extend, nv->counters[in]);
+	native_exec(game, WF_SHADE, WAVE_THREADS, 1);
+	if (nv->counters[SHADOW_COUNT] > 0)
+		native_rays(game, nv->packet > 1 ? PK_CONNECT : WF_CONNECT,
+		nv->counters[SHADOW_COUNT]);
+}
+
+static void	native_samples(t_game *game, t_native *nv)
+{
+	int		sample;
+
+	sample = -1;
+	while (++sample < SAMPLES)
+	{
+		nv->wave.sample = game->gpu.samples - SAMPLES + sample;
+		nv->wave.bounce = 0;
+		nv->wave.q_in = 0;
+		native_exec(game, WF_GENERATE, WAVE_THREADS, nv->views);
+		while (nv->wave.bounce < nv->wave.bounces)
+		{
+			native_bounce(game, nv);
+			nv->wave.bounce++;
+		}
+	}
+}
+
+/*
+** wavefront_render and the resolve of render_kernel on the pool. Every
+** launch is done before the next one starts, as on an in-order queue.
+*/
+
+void		native_trace(t_game *game)
+{
+	t_native	*nv;
+
+	nv = &game->native;
+	wavefront_setup(game, &nv->wave, nv->cams);
+	nv->wave.views = nv->views;
+	native_samples(game, nv);
+	native_exec(game, WF_ADAPT, WAVE_THREADS, 1);
+	native_exec(game, 0, game->frame.tw, game->frame.th);
+}
@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   native_state.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 21:10:00 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 21:10:00 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	*native_alloc(size_t size)
+{
+	void	*mem;
+
+	if (!(mem = ft_memalloc(size)))
+		terminate("native buffers do not fit into memory\n");
+	return (mem);
+}
+
+/*
+** Same slots as wavefront_views, a path per pixel and view.
+*/
+
+static void	native_paths(t_native *nv, size_t paths)
+{
+	nv->ray_o = native_alloc(sizeof(cl_float3) * paths);
+	nv->ray_d = native_alloc(sizeof(cl_float3) * paths);
+	nv->throughput = native_alloc(sizeof(cl_float3) * paths);
+	nv->sh_point = native_alloc(sizeof(cl_float3) * paths);
+	nv->sh_dir = native_alloc(sizeof(cl_float3) * paths);
+	nv->sh_weight = native_alloc(sizeof(cl_float3) * paths);
+	nv->hit_t = native_alloc(sizeof(cl_float) * paths);
+	nv->ray_pdf = native_alloc(sizeof(cl_float) * paths);
+	nv->hit_id = native_alloc(sizeof(cl_int) * paths);
+	nv->hit_prim = native_alloc(sizeof(cl_int) * paths);
+	nv->queue[0] = native_alloc(sizeof(cl_int) * paths);
+	nv->queue[1] = native_alloc(sizeof(cl_int) * paths);
+	nv->shadow_queue = native_alloc(sizeof(cl_int) * paths);
+}
+
+/*
+** What wavefront_state, denoise_init and post_init keep per pixel of the
+** bucket, apart from the blur buffers.
+*/
+
+static void	native_pixels(t_native *nv, size_t pixels)
+{
+	nv->radiance[0] = native_alloc(sizeof(cl_float3) * pixels);
+	nv->accum = native_alloc(sizeof(cl_float3) * pixels);
+	nv->moment = native_alloc(sizeof(cl_float) * pixels);
+	nv->spp = native_alloc(sizeof(cl_int) * pixels);
+	nv->active = native_alloc(sizeof(cl_int) * pixels * 2);
+	nv->albedo = native_alloc(sizeof(cl_float3) * pixels);
+	nv->normal = native_alloc(sizeof(cl_float3) * pixels);
+	nv->depth = native_alloc(sizeof(cl_float) * pixels);
+	nv->pass[0] = native_alloc(sizeof(cl_float4) * pixels);
+	nv->pass[1] = native_alloc(sizeof(cl_float4) * pixels);
+	nv->out = native_alloc(sizeof(cl_int) * pixels);
+	pixels = nv->views > 1 ? pixels : 1;
+	nv->radiance[1] = native_alloc(sizeof(cl_float3) * pixels);
+	nv->eye = native_alloc(sizeof(cl_float3) * pixels);
+}
+
+void		native_state(t_game *game)
+{
+	native_paths(&game->native, game->frame.cap * game->native.views);
+	native_pixels(&game->native, game->frame.cap);
+}
@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   obj_buffer.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/24 11:05:37 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/25 19:48:02 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** The device object buffers are sized by obj_cap, not obj_quantity. Edits
+** mark the records they changed and obj_flush only writes that range.
+** Adding or removing objects sets layout_dirty so the bvh is rebuilt,
+** any other edit just refits it. Any edit can change the power of a
+** light, so the emitter list is rebuilt first.
+*/
+
+void		obj_dirty(t_game *game, int first, int last)
+{
+	if (game->dirty_first > game->dirty_last)
+	{
+		game->dirty_first = first;
+		game->dirty_last = last;
+		return ;
+	}
+	if (first < game->dirty_first)
+		game->dirty_first = first;
+	if (last > game->dirty_last)
+		game->dirty_last = last;
+}
+
+void		obj_touch(t_game *game, t_obj *obj)
+{
+	int		i;
+
+	i = obj - game->gpu.objects;
+	if (i >= 0 && i < (int)game->obj_quantity)
+		obj_dirty(game, i, i);
+}
+
+void		obj_buffer_init(t_game *game)
+{
+	game->obj_dev_cap = game->obj_cap;
+	game->dirty_first = 0;
+	game->dirty_last = -1;
+	game->layout_dirty = 0;
+}
+
+static void	obj_buffer_grow(t_game *game)
+{
+	lights_build(game);
+	obj_pack(game, 0, -1);
+	obj_mem_grow(game, 1, sizeof(t_geom) * game->obj_cap, game->gpu.geoms);
+	obj_mem_grow(game, 21, sizeof(t_surface) * game->obj_cap,
+	game->gpu.surfaces);
+	obj_mem_grow(game, 22, sizeof(t_light) * game->obj_cap, game->gpu.lights);
+	game->obj_dev_cap = game->obj_cap;
+	obj_dirty(game, 0, game->obj_quantity - 1);
+}
+
+void		obj_flush(t_game *game)
+{
+	int		first;
+	int		count;
+
+	if (game->obj_quantity > game->obj_dev_cap)
+		obj_buffer_grow(game);
+	if (game->dirty_first > game->dirty_last && !game->layout_dirty)
+		return ;
+	lights_build(game);
+	if (game->dirty_last >= (int)game->obj_quantity)
+		game->dirty_last = game->obj_quantity - 1;
+	first = game->dirty_first;
+	count = game->dirty_last - first + 1;
+	if (count > 0)
+	{
+		obj_pack(game, first, first + count - 1);
+		obj_pack_write(game, first, count);
+	}
+	lights_write(game);
+	if (game->layout_dirty)
+		bvh_upload(game);
+	else
+		bvh_refit(game);
+	game->dirty_first = 0;
+	game->dirty_last = -1;
+	game->layout_dirty = 0;
+}
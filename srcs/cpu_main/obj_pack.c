@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   obj_pack.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/25 12:14:08 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/25 19:48:02 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	obj_pack_geom(t_obj *obj, t_geom *geom, int material)
+{
+	geom->position = obj->position;
+	geom->v = obj->v;
+	geom->vertices[0] = obj->vertices[0];
+	geom->vertices[1] = obj->vertices[1];
+	geom->vertices[2] = obj->vertices[2];
+	geom->radius = obj->radius;
+	geom->tor_radius = obj->tor_radius;
+	geom->type = obj->type;
+	geom->is_visible = obj->is_visible;
+	geom->material = material;
+	geom->mesh_root = obj->mesh_root;
+	geom->light_pick = obj->light_pick;
+}
+
+static void	obj_pack_surface(t_obj *obj, t_surface *surface)
+{
+	surface->color = obj->color;
+	surface->emission = obj->emission;
+	surface->basis[0] = obj->basis[0];
+	surface->basis[1] = obj->basis[1];
+	surface->basis[2] = obj->basis[2];
+	surface->shift = obj->shift;
+	surface->prolapse = obj->prolapse;
+	surface->metalness = obj->metalness;
+	surface->transparency = obj->transparency;
+	surface->refraction = obj->refraction;
+	surface->texture = obj->texture;
+	surface->normal = obj->normal;
+}
+
+/*
+** Refreshes the device side records of objects first to last, the staging
+** arrays follow obj_cap like the buffers they are written to.
+*/
+
+void		obj_pack(t_game *game, int first, int last)
+{
+	t_gpu	*gpu;
+
+	gpu = &game->gpu;
+	if (gpu->pack_cap < game->obj_cap)
+	{
+		gpu->pack_cap = game->obj_cap;
+		gpu->geoms = realloc(gpu->geoms, sizeof(t_geom) * gpu->pack_cap);
+		gpu->surfaces = realloc(gpu->surfaces,
+		sizeof(t_surface) * gpu->pack_cap);
+		if (!gpu->geoms || !gpu->surfaces)
+			terminate("Malloc ne ok\n");
+	}
+	while (first <= last)
+	{
+		obj_pack_geom(&gpu->objects[first], &gpu->geoms[first], first);
+		obj_pack_surface(&gpu->objects[first], &gpu->surfaces[first]);
+		first++;
+	}
+}
+
+void		obj_pack_write(t_game *game, int first, int count)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	game->cl_info->ret = clEnqueueWriteBuffer(game->cl_info->cmd_queue,
+	krl->args[1], CL_FALSE, sizeof(t_geom) * first, sizeof(t_geom) * count,
+	&game->gpu.geoms[first], 0, NULL, NULL);
+	game->cl_info->ret |= clEnqueueWriteBuffer(game->cl_info->cmd_queue,
+	krl->args[21], CL_TRUE, sizeof(t_surface) * first,
+	sizeof(t_surface) * count, &game->gpu.surfaces[first], 0, NULL, NULL);
+}
+
+void		obj_mem_grow(t_game *game, int arg, size_t size, void *host)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	clReleaseMemObject(krl->args[arg]);
+	cl_krl_init_arg(krl, arg, size, host);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, arg,
+	CL_MEM_READ_WRITE);
+	cl_krl_set_arg(krl, arg);
+}
@@ -6,19 +6,33 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/10 21:03:09 by jblack-b          #+#    #+#             */
-/*   Updated: 2019/12/10 21:07:08 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/24 11:31:09 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 #include "errno.h"
 
+/*
+** The array grows by doubling, so buttons that point into it stay valid
+** until it actually moves and in_cl rebuilds them.
+*/
+
 void		ft_object_push(t_game *game, t_obj *object)
 {
 	if (game->gpu.objects == NULL)
+	{
 		game->obj_quantity = 0;
-	game->gpu.objects = realloc(game->gpu.objects,
-	sizeof(t_obj) * (game->obj_quantity + 1));
+		game->obj_cap = 0;
+	}
+	if (game->obj_quantity == game->obj_cap)
+	{
+		game->obj_cap = game->obj_cap ? game->obj_cap * 2 : OBJ_CAP_MIN;
+		game->gpu.objects = realloc(game->gpu.objects,
+		sizeof(t_obj) * game->obj_cap);
+		if (!game->gpu.objects)
+			terminate("Malloc ne ok\n");
+	}
 	game->gpu.objects[game->obj_quantity] = *object;
 	game->obj_quantity += 1;
 	free(object);
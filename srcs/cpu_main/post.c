@@ -0,0 +1,149 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   post.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 16:42:08 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 21:10:00 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void			post_init(t_game *game)
+{
+	t_post	*p;
+
+	p = &game->post;
+	wavefront_kernel(game, POST_BLUR, "post_blur_kernel", 6);
+	wavefront_kernel(game, POST_PACK, "post_kernel", 8);
+	p->blur[0] = wavefront_buffer(game, sizeof(cl_float3) * game->frame.cap,
+	NULL);
+	p->blur[1] = wavefront_buffer(game, sizeof(cl_float3) * game->frame.cap,
+	NULL);
+	p->lut = wavefront_buffer(game, sizeof(cl_int) * 256, NULL);
+	p->look = -1;
+	wavefront_arg(game, POST_PACK, 2, &game->wf.spp);
+	wavefront_arg(game, POST_PACK, 3, &p->lut);
+}
+
+/*
+** Cartoon snaps a channel to CARTOON steps, sepia then tints the gray.
+*/
+
+void			post_lut(cl_int *table, cl_int look)
+{
+	int		i;
+	int		c;
+	int		v;
+
+	i = -1;
+	while (++i < 256 && (c = 24))
+	{
+		table[i] = 0;
+		while ((c -= 8) >= 0)
+		{
+			v = look & 1 ? (int)(floor(i / 255.0 * CARTOON) / CARTOON
+			* 255.0) : i;
+			v += look & POST_SEPIA ? SEPIA >> c & 0xFF : 0;
+			table[i] |= (v > 255 ? 255 : v) << c;
+		}
+	}
+}
+
+/*
+** Mode bits of post_kernel and its inputs apart from the frame itself,
+** the table is only uploaded again when the camera switches sepia or
+** cartoon.
+*/
+
+static cl_int	post_mode(t_game *game, t_cam *cam, cl_kernel krl)
+{
+	cl_int	mode;
+	cl_int	table[256];
+
+	mode = (cam->sepia == 1) * POST_SEPIA | (cam->cartoon == 1);
+	if (mode != game->post.look)
+	{
+		post_lut(table, mode);
+		game->cl_info->ret = cl_write(game->cl_info, game->post.lut,
+		sizeof(table), table);
+		game->post.look = mode;
+	}
+	mode = (mode & POST_SEPIA) | (cam->stereo == 1) * POST_STEREO
+	| (game->keys.heat != 0) * POST_HEAT;
+	wavefront_arg(game, POST_PACK, 1, &game->wf.eye);
+	game->cl_info->ret |= clSetKernelArg(krl, 6, sizeof(cl_int),
+	&game->gpu.samples);
+	game->cl_info->ret |= clSetKernelArg(krl, 7, sizeof(cl_int), &mode);
+	return (mode);
+}
+
+/*
+** Rows first, then columns of the rows, each launch in groups of
+** POST_GROUP pixels along the direction it blurs.
+*/
+
+static float	post_blur(t_game *game, cl_mem **in, float inv)
+{
+	cl_kernel	krl;
+	cl_int2		size;
+	size_t		range[4];
+	cl_int		axis;
+
+	krl = game->cl_info->progs[0].krls[POST_BLUR].krl;
+	size.s[0] = game->frame.tw;
+	size.s[1] = game->frame.th;
+	range[2] = POST_GROUP;
+	range[3] = 1;
+	game->cl_info->ret |= clSetKernelArg(krl, 5, sizeof(cl_int2), &size);
+	axis = -1;
+	while (++axis < 2)
+	{
+		range[0] = (size.s[axis] + POST_GROUP - 1) / POST_GROUP * POST_GROUP;
+		range[1] = size.s[!axis];
+		wavefront_arg(game, POST_BLUR, 0, axis ? &game->post.blur[0] : *in);
+		wavefront_arg(game, POST_BLUR, 1, &game->post.blur[axis]);
+		game->cl_info->ret |= clSetKernelArg(krl, 2, sizeof(cl_float), &inv);
+		game->cl_info->ret |= clSetKernelArg(krl, 4, sizeof(cl_int), &axis);
+		krl_exec_local(game, POST_BLUR, range, range + 2);
+		inv = 1.f;
+	}
+	*in = &game->post.blur[1];
+	return (inv);
+}
+
+/*
+** Picks what the frame is made from: the denoised image when the filter
+** ran, the accumulation otherwise, blurred when the camera asks for it.
+*/
+
+void			post_run(t_game *game)
+{
+	t_cam		*cam;
+	cl_kernel	krl;
+	cl_mem		*in;
+	float		inv;
+	size_t		global[2];
+
+	cam = &game->gpu.camera[game->cam_num];
+	in = &game->cl_info->progs[0].krls[0].args[2];
+	inv = game->dn.result >= 0 ? 1.f : 1.f / game->gpu.samples;
+	if (game->dn.result >= 0)
+		in = &game->dn.pass[game->dn.result];
+	krl = game->cl_info->progs[0].krls[POST_BLUR].krl;
+	game->cl_info->ret |= clSetKernelArg(krl, 3, sizeof(cl_float),
+	&cam->motion_blur);
+	krl = game->cl_info->progs[0].krls[POST_PACK].krl;
+	if (!(post_mode(game, cam, krl) & (POST_HEAT | POST_STEREO))
+	&& cam->motion_blur > 0 && game->gpu.samples > SAMPLES)
+		inv = post_blur(game, &in, inv);
+	global[0] = game->frame.tw;
+	global[1] = game->frame.th;
+	wavefront_arg(game, POST_PACK, 0, in);
+	wavefront_arg(game, POST_PACK, 4, &game->present.target);
+	game->cl_info->ret |= clSetKernelArg(krl, 5, sizeof(cl_float), &inv);
+	krl_exec(game, POST_PACK, 2, global);
+}
@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   present.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/23 17:40:12 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 16:42:08 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Frames are presented one launch late: post_kernel writes the output
+** buffer of the current slot and a non-blocking read copies it into
+** pinned host memory, while the host waits only for the previous slot.
+** The first slot is the render_kernel output argument of the scene, the
+** second one and the pinned staging buffers live as long as the context.
+** They cover one bucket, the host copies it into its place on the surface.
+** A scaled frame is packed into the low buffer and upscaled into the slot.
+*/
+
+void	present_init(t_game *game)
+{
+	t_present	*p;
+	cl_context	context;
+	size_t		size;
+	int			i;
+
+	p = &game->present;
+	size = sizeof(cl_int) * game->frame.cap;
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	p->out[1] = clCreateBuffer(context, CL_MEM_READ_WRITE, size, NULL,
+	&game->cl_info->ret);
+	i = -1;
+	while (++i < 2)
+	{
+		p->pinned[i] = clCreateBuffer(context, CL_MEM_READ_WRITE |
+		CL_MEM_ALLOC_HOST_PTR, size, NULL, &game->cl_info->ret);
+		p->host[i] = clEnqueueMapBuffer(game->cl_info->cmd_queue,
+		p->pinned[i], CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size, 0,
+		NULL, NULL, &game->cl_info->ret);
+		p->pending[i] = 0;
+	}
+	if (game->cl_info->ret != CL_SUCCESS)
+		terminate("could not allocate the present buffers\n");
+	p->cur = 0;
+}
+
+void	present_bind(t_game *game)
+{
+	t_present	*p;
+
+	p = &game->present;
+	p->out[0] = game->cl_info->progs[0].krls[0].args[0];
+	p->target = game->frame.scale > 1 ? game->scale.low : p->out[p->cur];
+}
+
+void	present_read(t_game *game)
+{
+	t_present	*p;
+
+	p = &game->present;
+	game->cl_info->ret = clEnqueueReadBuffer(game->cl_info->cmd_queue,
+	p->out[p->cur], CL_FALSE, 0,
+	sizeof(cl_int) * game->frame.ow * game->frame.oh,
+	p->host[p->cur], 0, NULL, &p->read[p->cur]);
+	clFlush(game->cl_info->cmd_queue);
+	p->pending[p->cur] = 1;
+	p->cur = !p->cur;
+}
+
+void	present_wait(t_game *game, int slot)
+{
+	t_present	*p;
+
+	p = &game->present;
+	if (!p->pending[slot])
+		return ;
+	clWaitForEvents(1, &p->read[slot]);
+	clReleaseEvent(p->read[slot]);
+	p->pending[slot] = 0;
+	frame_present(game, p->host[slot]);
+}
+
+/*
+** Shows the newest frame, needed whenever no further launch will follow
+** or before the output buffers are released.
+*/
+
+void	present_flush(t_game *game)
+{
+	present_wait(game, game->present.cur);
+	present_wait(game, !game->present.cur);
+}
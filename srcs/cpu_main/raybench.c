@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   raybench.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 22:05:12 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:20:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void		raybench_usage(void)
+{
+	terminate("usage: ./RT --raybench scene.json [--threads N] [--runs N]");
+}
+
+static void		raybench_args(t_raybench *rb, int argc, char **argv)
+{
+	int		i;
+
+	ft_bzero(rb, sizeof(t_raybench));
+	rb->runs = RAYBENCH_RUNS;
+	i = 1;
+	while (++i < argc)
+	{
+		if (!ft_strcmp(argv[i], "--threads") && i + 1 < argc)
+			rb->threads = ft_atoi(argv[++i]);
+		else if (!ft_strcmp(argv[i], "--runs") && i + 1 < argc)
+			rb->runs = ft_atoi(argv[++i]);
+		else if (argv[i][0] != '-' && !rb->scene)
+			rb->scene = argv[i];
+		else
+			raybench_usage();
+	}
+	if (!rb->scene || rb->threads < 0 || rb->runs <= 0)
+		raybench_usage();
+}
+
+/*
+** Millions of rays per second and core, a core is a worker of the pool.
+*/
+
+static double	raybench_rate(t_raybench *rb, int pass, int packet, int cores)
+{
+	double	seconds;
+
+	seconds = rb->ms[pass][packet] / 1000.0;
+	if (seconds <= 0.0)
+		return (0.0);
+	return ((double)rb->rays[pass] * rb->runs / seconds / cores / 1e6);
+}
+
+static void		raybench_report(t_game *game, t_raybench *rb)
+{
+	int		cores;
+	int		isa;
+	int		i;
+
+	cores = game->native.pool.num;
+	isa = game->native.isa;
+	printf("%s: %d threads, packets of %d rays (%s)\n", rb->scene, cores,
+	game->native.packet, isa == NATIVE_AVX2 ? "avx2" :
+	(isa == NATIVE_SSE42 ? "sse4.2" : "base"));
+	i = -1;
+	while (++i < 2)
+	{
+		printf("    %-8s %9d rays  single %8.3f  packet %8.3f Mrays/s "
+		"per core  x%.2f", i ? "shadow" : "primary", rb->rays[i],
+		raybench_rate(rb, i, 0, cores), raybench_rate(rb, i, 1, cores),
+		rb->ms[i][1] > 0.0 ? rb->ms[i][0] / rb->ms[i][1] : 0.0);
+		printf("  %d mismatched\n", rb->mismatch[i]);
+	}
+}
+
+/*
+** Times the closest hit and shadow queries of one frame of a scene on
+** the native backend, through the single ray and the packet kernels.
+*/
+
+int				raybench_main(int argc, char **argv)
+{
+	t_game		game;
+	t_gui		gui;
+	t_raybench	rb;
+
+	raybench_args(&rb, argc, argv);
+	frame_init(&game, WIN_W, WIN_H, 0);
+	headless_setup(&game, &gui, 1);
+	native_init(&game, rb.scene, rb.threads);
+	raybench_run(&game, &rb);
+	raybench_report(&game, &rb);
+	SDL_FreeSurface(game.sdl.surface);
+	return (0);
+}
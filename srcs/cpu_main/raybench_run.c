@@ -0,0 +1,111 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   raybench_run.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 22:05:12 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 22:05:12 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Wall time of runs launches of krl over the rays queued for it.
+*/
+
+static double	raybench_pass(t_game *game, int krl, int rays, int runs)
+{
+	Uint64	time;
+	int		i;
+
+	time = SDL_GetPerformanceCounter();
+	i = -1;
+	while (++i < runs)
+		native_rays(game, krl, rays);
+	return (bench_ms(time));
+}
+
+/*
+** The camera rays generate queues for the first bounce. Both kernels fill
+** the same hit buffers and have to agree on the object every ray hits.
+*/
+
+static void		raybench_primary(t_game *game, t_native *nv, t_raybench *rb)
+{
+	cl_int	*hits;
+	int		rays;
+	int		i;
+
+	native_exec(game, WF_GENERATE, WAVE_THREADS, nv->views);
+	rays = nv->counters[0];
+	nv->krl[WF_EXTEND].arg[WF_ARG + 5] = nv->queue[0];
+	nv->krl[PK_EXTEND].arg[WF_ARG + 5] = nv->queue[0];
+	rb->ms[0][0] = raybench_pass(game, WF_EXTEND, rays, rb->runs);
+	hits = malloc_exit(sizeof(cl_int) * (rays + 1));
+	i = -1;
+	while (++i < rays)
+		hits[i] = nv->hit_id[nv->queue[0][i]];
+	rb->ms[0][1] = raybench_pass(game, PK_EXTEND, rays, rb->runs);
+	i = -1;
+	while (++i < rays)
+		rb->mismatch[0] += hits[i] != nv->hit_id[nv->queue[0][i]];
+	rb->rays[0] = rays;
+	free(hits);
+}
+
+/*
+** Shading the first hits gives the shadow rays. The radiance the single
+** rays let through is put back before the packets run, both have to end
+** on the same image.
+*/
+
+static void		raybench_shadow(t_game *game, t_native *nv, t_raybench *rb)
+{
+	cl_float3	*base;
+	cl_float3	*single;
+	size_t		size;
+	int			i;
+
+	nv->krl[WF_SHADE].arg[WF_ARG + 6] = nv->queue[0];
+	nv->krl[WF_SHADE].arg[WF_ARG + 7] = nv->queue[1];
+	native_exec(game, WF_SHADE, WAVE_THREADS, 1);
+	rb->rays[1] = nv->counters[SHADOW_COUNT];
+	size = sizeof(cl_float3) * game->frame.cap;
+	base = malloc_exit(size);
+	single = malloc_exit(size);
+	ft_memcpy(base, nv->radiance[0], size);
+	rb->ms[1][0] = raybench_pass(game, WF_CONNECT, rb->rays[1], rb->runs);
+	ft_memcpy(single, nv->radiance[0], size);
+	ft_memcpy(nv->radiance[0], base, size);
+	rb->ms[1][1] = raybench_pass(game, PK_CONNECT, rb->rays[1], rb->runs);
+	i = -1;
+	while (++i < (int)game->frame.cap)
+		rb->mismatch[1] += ft_memcmp(single + i, nv->radiance[0] + i,
+		sizeof(cl_float) * 3) != 0;
+	free(base);
+	free(single);
+}
+
+/*
+** The first bounce of the first sample as native_trace would start it,
+** with light sampling on so shade queues shadow rays.
+*/
+
+void			raybench_run(t_game *game, t_raybench *rb)
+{
+	t_native	*nv;
+
+	nv = &game->native;
+	game->gpu.samples = SAMPLES;
+	wavefront_setup(game, &nv->wave, nv->cams);
+	nv->wave.views = nv->views;
+	nv->wave.lightsampling = 1;
+	nv->wave.sample = 0;
+	nv->wave.bounce = 0;
+	nv->wave.q_in = 0;
+	raybench_primary(game, nv, rb);
+	raybench_shadow(game, nv, rb);
+}
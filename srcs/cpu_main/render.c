@@ -6,7 +6,7 @@
 /*   By: sbrella <sbrella@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/23 14:54:28 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 18:14:39 by sbrella          ###   ########.fr       */
+/*   Updated: 2019/12/27 19:24:51 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,32 +14,40 @@
 
 void			ft_run_kernel(t_game *game, t_cl_krl *kernel)
 {
-	size_t	global[2];
-
-	global[0] = WIN_W;
-	global[1] = WIN_H;
 	game->gpu.samples += SAMPLES;
-	game->cl_info->ret |= clSetKernelArg(kernel->krl, 6, sizeof(cl_int),
-	&game->obj_quantity);
-	game->cl_info->ret |= clSetKernelArg(kernel->krl, 7, sizeof(cl_int),
-	&game->gpu.samples);
-	game->cl_info->ret |= clSetKernelArg(kernel->krl, 8, sizeof(t_cam),
-	&game->gpu.camera[game->cam_num]);
-	game->cl_info->ret |= clSetKernelArg(kernel->krl, 9, sizeof(int),
-	&(game->keys.r));
-	game->cl_info->ret = cl_krl_exec(game->cl_info, kernel->krl, 2, global);
-	clFinish(game->cl_info->cmd_queue);
-	game->cl_info->ret = cl_read(game->cl_info, kernel->args[0],
-	sizeof(cl_int) * WIN_W * WIN_H, game->sdl.surface->pixels);
+	split_trace(game, kernel);
+}
+
+/*
+** Turns the accumulation into the shown frame, once per frame however many
+** sample launches went into it. The bands of the other devices come in
+** first.
+*/
+
+void			ft_display(t_game *game)
+{
+	split_merge(game);
+	present_bind(game);
+	denoise_run(game);
+	post_run(game);
+	scale_upscale(game);
+	present_read(game);
+	bench_collect(game);
+	present_wait(game, game->present.cur);
 }
 
 void			ft_render(t_game *game, t_gui *gui)
 {
+	scale_rest(game);
 	if (!game->flag && !gui->flag)
+	{
+		present_flush(game);
 		return ;
+	}
 	game->flag = 0;
 	gui->flag = 0;
 	ft_run_kernel(game, &game->cl_info->progs[0].krls[0]);
+	ft_display(game);
 }
 
 void			screen_present(t_game *game, t_gui *gui)
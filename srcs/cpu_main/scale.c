@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   scale.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 14:05:12 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 18:10:30 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void		scale_init(t_game *game)
+{
+	t_scale	*s;
+
+	s = &game->scale;
+	wavefront_kernel(game, UPSCALE, "upscale_kernel", 5);
+	s->low = wavefront_buffer(game, sizeof(cl_int) * game->frame.cap, NULL);
+	wavefront_arg(game, UPSCALE, 0, &s->low);
+	s->level = 1;
+	s->moving = 0;
+	s->tick = 0;
+}
+
+/*
+** Runs last on a scaled frame and fills the output slot present reads.
+*/
+
+void		scale_upscale(t_game *game)
+{
+	cl_kernel	krl;
+	size_t		global[2];
+
+	if (game->frame.scale < 2)
+		return ;
+	krl = game->cl_info->progs[0].krls[UPSCALE].krl;
+	global[0] = game->frame.pw;
+	global[1] = game->frame.ph;
+	game->cl_info->ret |= clSetKernelArg(krl, 1, sizeof(cl_mem),
+	&game->present.out[game->present.cur]);
+	game->cl_info->ret |= clSetKernelArg(krl, 2, sizeof(cl_int),
+	&game->frame.w);
+	game->cl_info->ret |= clSetKernelArg(krl, 3, sizeof(cl_int),
+	&game->frame.h);
+	game->cl_info->ret |= clSetKernelArg(krl, 4, sizeof(cl_int),
+	&game->frame.scale);
+	krl_exec(game, UPSCALE, 2, global);
+}
+
+static int	scale_set(t_game *game, int scale)
+{
+	if (scale == game->frame.scale)
+		return (0);
+	frame_scale(game, scale);
+	return (1);
+}
+
+/*
+** Called on every frame that resets the accumulation, before the camera
+** is rebuilt. The time since the previous one is the whole frame as the
+** fps counter sees it: over the target the scale doubles, when a frame
+** four times larger would still fit it halves.
+*/
+
+void		scale_motion(t_game *game)
+{
+	t_scale	*s;
+	Uint32	now;
+	Uint32	ms;
+
+	s = &game->scale;
+	now = SDL_GetTicks();
+	ms = now - s->tick;
+	if (s->target > 0 && !s->moving)
+		scale_set(game, s->level);
+	else if (s->target > 0 && ms > (Uint32)s->target
+	&& game->frame.scale < SCALE_MAX)
+		scale_set(game, game->frame.scale * 2);
+	else if (s->target > 0 && ms * 4 < (Uint32)s->target
+	&& game->frame.scale > 1)
+		scale_set(game, game->frame.scale / 2);
+	s->moving = 1;
+	s->tick = now;
+}
+
+/*
+** Once nothing changed for SCALE_REST ms the window goes back to the full
+** size and starts accumulating from scratch, a frame that just moved is
+** always too recent for it.
+*/
+
+void		scale_rest(t_game *game)
+{
+	t_scale	*s;
+
+	s = &game->scale;
+	if (!s->moving || SDL_GetTicks() - s->tick < SCALE_REST)
+		return ;
+	s->moving = 0;
+	s->level = game->frame.scale;
+	if (!scale_set(game, 1))
+		return ;
+	game->cl_info->ret = cl_write(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[2],
+	sizeof(cl_float3) * game->frame.cap, game->gpu.vec_temp);
+	game->gpu.samples = 0;
+	reconfigure_camera(game, &game->gpu.camera[game->cam_num]);
+	game->flag = 1;
+}
@@ -0,0 +1,155 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   split.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 19:24:51 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 19:24:51 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** One lane's share of a sample launch: the wavefront stages, then the
+** resolve over the rows of its band.
+*/
+
+static void	split_launch(t_game *game, t_cl_krl *kernel)
+{
+	size_t	global[2];
+
+	global[0] = game->frame.tw;
+	global[1] = game->frame.th;
+	wavefront_render(game);
+	game->cl_info->ret |= clSetKernelArg(kernel->krl, 5, sizeof(cl_int),
+	&game->obj_quantity);
+	game->cl_info->ret |= clSetKernelArg(kernel->krl, 6, sizeof(cl_int),
+	&game->gpu.samples);
+	game->cl_info->ret |= clSetKernelArg(kernel->krl, 7, sizeof(t_cam),
+	&game->gpu.camera[game->cam_num]);
+	game->cl_info->ret |= clSetKernelArg(kernel->krl, 8, sizeof(int),
+	&(game->keys.r));
+	game->cl_info->ret |= clSetKernelArg(kernel->krl, 14, sizeof(cl_int),
+	&game->bvh.unbounded_num);
+	krl_exec(game, 0, 2, global);
+}
+
+/*
+** Rows go to the lanes by the rows per ms they last managed, evenly until
+** every lane was timed once. Each lane keeps at least a row, the last one
+** takes whatever rounding left.
+*/
+
+static void	split_bands(t_game *game, t_split *s)
+{
+	t_lane	*lane;
+	double	sum;
+	int		i;
+
+	sum = 0;
+	i = -1;
+	while (++i < s->num)
+	{
+		lane_time(&s->lane[i], 1);
+		sum = sum < 0 || s->lane[i].rate <= 0 ? -1 : sum + s->lane[i].rate;
+	}
+	s->th = game->frame.th;
+	i = -1;
+	while (++i < s->num)
+	{
+		lane = &s->lane[i];
+		lane->row = i ? lane[-1].row + lane[-1].rows : 0;
+		lane->rows = sum < 0 ? s->th / s->num : (int)(s->th * lane->rate
+		/ sum + 0.5);
+		lane->rows += lane->rows < 1;
+		if (i == s->num - 1
+		|| lane->rows > s->th - lane->row - (s->num - 1 - i))
+			lane->rows = s->th - lane->row - (s->num - 1 - i);
+	}
+}
+
+/*
+** The bands are only cut again when the accumulation starts over, the
+** buffers of a lane hold its rows until then. Every lane traces the
+** bucket shrunk to its band, the other devices on their own queues. A
+** bucket with fewer rows than lanes stays on the first device.
+*/
+
+void		split_trace(t_game *game, t_cl_krl *kernel)
+{
+	t_split	*s;
+	t_frame	full;
+	int		i;
+
+	s = &game->split;
+	if (s->num < 2 || game->frame.th < s->num)
+	{
+		s->th = 0;
+		split_launch(game, kernel);
+		return ;
+	}
+	if (game->gpu.samples == SAMPLES || s->th != game->frame.th)
+		split_bands(game, s);
+	full = game->frame;
+	i = -1;
+	while (++i < s->num)
+	{
+		game->frame.y = full.y + s->lane[i].row;
+		game->frame.th = s->lane[i].rows;
+		lane_begin(game, &s->lane[i]);
+		split_launch(game, kernel);
+		lane_end(game, &s->lane[i]);
+	}
+	game->frame = full;
+}
+
+/*
+** Lane buffers all hold frame.cap elements, so their size gives the
+** element the band offsets are counted in.
+*/
+
+static void	split_copy(t_game *game, t_lane *lane, cl_mem src, cl_mem dst)
+{
+	size_t	elem;
+
+	clGetMemObjectInfo(src, CL_MEM_SIZE, sizeof(size_t), &elem, NULL);
+	elem /= game->frame.cap;
+	if (lane->merged)
+		clReleaseEvent(lane->merged);
+	game->cl_info->ret |= clEnqueueCopyBuffer(game->cl_info->cmd_queue,
+	src, dst, 0, elem * lane->row * game->frame.tw,
+	elem * lane->rows * game->frame.tw, 1, &lane->done, &lane->merged);
+}
+
+/*
+** Copies the bands of the other devices into the shown buffers once
+** their launches are done, before anything reads the frame. Only the
+** copies wait for them, a lane waits for its copies in lane_begin.
+*/
+
+void		split_merge(t_game *game)
+{
+	t_lane	*lane;
+	int		i;
+
+	i = 0;
+	while (game->split.th && ++i < game->split.num)
+	{
+		lane = &game->split.lane[i];
+		clEnqueueMarkerWithWaitList(lane->queue, 0, NULL, &lane->done);
+		clFlush(lane->queue);
+		split_copy(game, lane, lane->accum,
+		game->cl_info->progs[0].krls[0].args[2]);
+		split_copy(game, lane, lane->dn.albedo, game->dn.albedo);
+		split_copy(game, lane, lane->dn.normal, game->dn.normal);
+		split_copy(game, lane, lane->dn.depth, game->dn.depth);
+		split_copy(game, lane, lane->wf.moment, game->wf.moment);
+		split_copy(game, lane, lane->wf.spp, game->wf.spp);
+		if (game->wf.views > 1)
+			split_copy(game, lane, lane->wf.eye, game->wf.eye);
+		clReleaseEvent(lane->done);
+	}
+}
@@ -0,0 +1,92 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   split_init.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 19:24:51 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 19:24:51 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** A device takes part when main.cl built for it.
+*/
+
+static int	split_usable(t_game *game, cl_device_id device)
+{
+	cl_program		program;
+	cl_build_status	status;
+
+	clGetKernelInfo(game->cl_info->progs[0].krls[0].krl, CL_KERNEL_PROGRAM,
+	sizeof(cl_program), &program, NULL);
+	status = CL_BUILD_NONE;
+	clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_STATUS,
+	sizeof(cl_build_status), &status, NULL);
+	return (status == CL_BUILD_SUCCESS);
+}
+
+/*
+** Lane queues are profiled for the timing, the buffers are sized for a
+** whole bucket so the bands can move without reallocating.
+*/
+
+static void	lane_create(t_game *game, t_lane *lane, cl_context context,
+			cl_device_id device)
+{
+	t_wavefront	wf;
+	size_t		size;
+
+	lane->queue = clCreateCommandQueue(context, device,
+	CL_QUEUE_PROFILING_ENABLE, &game->cl_info->ret);
+	if (game->cl_info->ret != CL_SUCCESS)
+		terminate("could not create a command queue for a device\n");
+	size = sizeof(cl_float3) * game->frame.cap;
+	lane->accum = wavefront_buffer(game, size, game->gpu.vec_temp);
+	lane->dn.albedo = wavefront_buffer(game, size, NULL);
+	lane->dn.normal = wavefront_buffer(game, size, NULL);
+	lane->dn.depth = wavefront_buffer(game,
+	sizeof(cl_float) * game->frame.cap, NULL);
+	wf = game->wf;
+	wavefront_state(game);
+	lane->wf = game->wf;
+	game->wf = wf;
+	wavefront_bind(game);
+}
+
+/*
+** Every device of the context cl_init made gets a lane, the one it picked
+** is the first. The shared context lets all of them read the scene the
+** host uploads once, devices of other platforms cannot.
+*/
+
+void		split_init(t_game *game)
+{
+	cl_context		context;
+	cl_device_id	*devices;
+	cl_device_id	first;
+	cl_uint			num;
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_DEVICE,
+	sizeof(cl_device_id), &first, NULL);
+	num = 1;
+	clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES, sizeof(cl_uint), &num,
+	NULL);
+	devices = ft_memalloc(sizeof(cl_device_id) * num);
+	game->split.lane = ft_memalloc(sizeof(t_lane) * num);
+	game->split.num = 1;
+	clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(cl_device_id) * num,
+	devices, NULL);
+	while (num--)
+		if (devices[num] != first && split_usable(game, devices[num]))
+			lane_create(game, &game->split.lane[game->split.num++], context,
+			devices[num]);
+	free(devices);
+	if (game->split.num > 1)
+		bench_queue(game);
+}
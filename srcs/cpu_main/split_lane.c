@@ -0,0 +1,113 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   split_lane.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 19:24:51 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 19:24:51 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Trades the queue, the path state and the per pixel buffers of the game
+** for the ones of a lane and binds them, called again to trade back.
+*/
+
+void		lane_swap(t_game *game, t_lane *lane)
+{
+	cl_command_queue	queue;
+	t_wavefront			wf;
+	t_denoise			dn;
+	cl_mem				accum;
+
+	queue = game->cl_info->cmd_queue;
+	game->cl_info->cmd_queue = lane->queue;
+	lane->queue = queue;
+	wf = game->wf;
+	game->wf = lane->wf;
+	lane->wf = wf;
+	dn = game->dn;
+	game->dn = lane->dn;
+	lane->dn = dn;
+	accum = game->cl_info->progs[0].krls[0].args[2];
+	game->cl_info->progs[0].krls[0].args[2] = lane->accum;
+	lane->accum = accum;
+	wavefront_bind(game);
+	wavefront_arg(game, 0, 2, &game->cl_info->progs[0].krls[0].args[2]);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 15, &game->dn.albedo);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 16, &game->dn.normal);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 17, &game->dn.depth);
+}
+
+/*
+** The first lane is the game itself. The others wait for the copies of
+** their previous band before writing over it.
+*/
+
+void		lane_begin(t_game *game, t_lane *lane)
+{
+	if (lane != game->split.lane)
+		lane_swap(game, lane);
+	if (lane->merged)
+	{
+		clEnqueueBarrierWithWaitList(game->cl_info->cmd_queue, 1,
+		&lane->merged, NULL);
+		clReleaseEvent(lane->merged);
+		lane->merged = NULL;
+	}
+	lane_time(lane, 0);
+	if (!lane->marks)
+		clEnqueueMarkerWithWaitList(game->cl_info->cmd_queue, 0, NULL,
+		&lane->mark[0]);
+	lane->marks += !lane->marks;
+}
+
+void		lane_end(t_game *game, t_lane *lane)
+{
+	if (lane->marks == 1)
+		clEnqueueMarkerWithWaitList(game->cl_info->cmd_queue, 0, NULL,
+		&lane->mark[1]);
+	lane->marks += lane->marks == 1;
+	if (lane == game->split.lane)
+		return ;
+	clFlush(game->cl_info->cmd_queue);
+	lane_swap(game, lane);
+}
+
+/*
+** A lane is timed over one launch between two markers, the next one once
+** the last was read. The rows per ms are averaged with what came before.
+*/
+
+void		lane_time(t_lane *lane, int wait)
+{
+	cl_int		status;
+	cl_ulong	time[2];
+	double		ms;
+
+	if (lane->marks != 2)
+		return ;
+	if (wait)
+		clWaitForEvents(1, &lane->mark[1]);
+	clGetEventInfo(lane->mark[1], CL_EVENT_COMMAND_EXECUTION_STATUS,
+	sizeof(cl_int), &status, NULL);
+	if (status != CL_COMPLETE)
+		return ;
+	time[0] = 0;
+	time[1] = 0;
+	clGetEventProfilingInfo(lane->mark[0], CL_PROFILING_COMMAND_END,
+	sizeof(cl_ulong), &time[0], NULL);
+	clGetEventProfilingInfo(lane->mark[1], CL_PROFILING_COMMAND_END,
+	sizeof(cl_ulong), &time[1], NULL);
+	clReleaseEvent(lane->mark[0]);
+	clReleaseEvent(lane->mark[1]);
+	lane->marks = 0;
+	ms = (double)(time[1] - time[0]) / 1000000.0;
+	if (ms > 0 && time[0])
+		lane->rate = lane->rate > 0 ? (lane->rate + lane->rows / ms) / 2
+		: lane->rows / ms;
+}
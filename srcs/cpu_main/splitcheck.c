@@ -0,0 +1,149 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   splitcheck.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 23:52:16 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:52:16 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Largest difference of a pixel of image against the one of the single
+** device render, relative to the brighter of the two.
+*/
+
+static double	splitcheck_pixel(cl_float3 *ref, cl_float3 *image, int i)
+{
+	double	err;
+	double	d;
+	int		c;
+
+	err = 0.0;
+	c = -1;
+	while (++c < 3)
+	{
+		d = fabs(ref[i].s[c] - image[i].s[c]) / fmax(fmax(fabs(ref[i].s[c]),
+		fabs(image[i].s[c])), 1e-3);
+		err = fmax(err, d);
+	}
+	return (err);
+}
+
+/*
+** worst[0] is the worst pixel of the frame, worst[1] the worst one on the
+** rows next to a seam between two bands.
+*/
+
+static void		splitcheck_diff(t_game *game, cl_float3 *ref,
+				cl_float3 *image, double *worst)
+{
+	double	err;
+	int		seam;
+	int		i;
+	int		l;
+
+	i = -1;
+	while (++i < game->frame.w * game->frame.h)
+	{
+		err = splitcheck_pixel(ref, image, i);
+		worst[0] = fmax(worst[0], err);
+		seam = 0;
+		l = 0;
+		while (++l < game->split.num)
+			seam |= abs(i / game->frame.w - game->split.lane[l].row) <= 1;
+		if (seam)
+			worst[1] = fmax(worst[1], err);
+	}
+}
+
+/*
+** One render as headless makes it, the denoised image goes to image and
+** the raw accumulation of the first device to raw.
+*/
+
+static void		splitcheck_render(t_game *game, t_check *check,
+				cl_float3 *image, cl_float3 *raw)
+{
+	t_headless	opt;
+
+	ft_bzero(&opt, sizeof(t_headless));
+	opt.spp = check->spp;
+	headless_tile(game, &opt, image);
+	game->cl_info->ret = cl_read(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[2],
+	sizeof(cl_float3) * game->frame.cap, raw);
+}
+
+/*
+** The first render keeps to the first device. The second one cuts the
+** bands evenly, the third cuts them again at its first launch for lane
+** rates of 1, 2, 3... so the seams move.
+*/
+
+static void		splitcheck_passes(t_game *game, t_check *check,
+				cl_float3 **img)
+{
+	int		num;
+	int		pass;
+	int		l;
+
+	num = game->split.num;
+	game->split.num = 1;
+	splitcheck_render(game, check, img[0], img[1]);
+	game->split.num = num;
+	pass = 0;
+	while (++pass < 3)
+	{
+		l = -1;
+		while (pass == 2 && ++l < num)
+		{
+			lane_time(&game->split.lane[l], 1);
+			game->split.lane[l].rate = l + 1;
+		}
+		splitcheck_render(game, check, img[2], img[3]);
+		splitcheck_diff(game, img[0], img[2], check->worst[0]);
+		splitcheck_diff(game, img[1], img[3], check->worst[1]);
+		printf("    pass %d: band rows", pass);
+		l = -1;
+		while (++l < num)
+			printf(" %d%s", game->split.lane[l].rows, l + 1 < num ? "" : "\n");
+	}
+}
+
+/*
+** A fixed scene rendered on the first device alone and then split in
+** bands across every device of the context, with adaptive sampling and
+** the denoiser on, has to come out the same.
+*/
+
+int				splitcheck_main(t_check *check)
+{
+	t_game		game;
+	t_gui		gui;
+	cl_float3	*img[4];
+	int			i;
+
+	frame_init(&game, CHECK_W, CHECK_H, 0);
+	headless_setup(&game, &gui, 0);
+	opencl(&game, check->scene);
+	if (game.split.num < 2)
+		terminate("--splitcheck needs two devices in the context, try "
+		"POCL_DEVICES=\"pthread pthread\"");
+	game.keys.r = 1;
+	game.gpu.camera[game.cam_num].denoise = 1;
+	printf("%s: %d spp, %d devices\n", check->scene, check->spp,
+	game.split.num);
+	i = -1;
+	while (++i < 4)
+		img[i] = malloc_exit(sizeof(cl_float3) * game.frame.cap);
+	splitcheck_passes(&game, check, img);
+	while (i--)
+		free(img[i]);
+	SDL_FreeSurface(game.sdl.surface);
+	return (check_worst(check));
+}
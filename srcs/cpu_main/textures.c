@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/02 15:55:58 by sbrella           #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/19 17:25:03 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -22,7 +22,42 @@ static void	ya_kostil(SDL_PixelFormat *fmt)
 	fmt->Amask = AMASK;
 }
 
-void		get_texture(char *name, t_txture *texture, char *path)
+static void	tex_blank(t_game *game, t_txture *texture)
+{
+	cl_int	white;
+
+	white = -1;
+	texture->format = TEX_ARGB8;
+	texture->width = 1;
+	texture->height = 1;
+	texture->offset = atlas_push(&game->atlas, &white, 1);
+}
+
+/*
+** All images share one pixel buffer, a texture is only its offset and size.
+*/
+
+cl_int		atlas_push(t_atlas *atlas, cl_int *pixels, size_t count)
+{
+	size_t	offset;
+
+	offset = atlas->size;
+	if (atlas->size + count > atlas->cap)
+	{
+		if (!atlas->cap)
+			atlas->cap = 1;
+		while (atlas->cap < atlas->size + count)
+			atlas->cap *= 2;
+		atlas->pixels = realloc(atlas->pixels, sizeof(cl_int) * atlas->cap);
+		if (!atlas->pixels)
+			terminate("Malloc ne ok\n");
+	}
+	ft_memcpy(atlas->pixels + offset, pixels, sizeof(cl_int) * count);
+	atlas->size += count;
+	return ((cl_int)offset);
+}
+
+void		get_texture(t_game *game, char *name, t_txture *texture, char *path)
 {
 	SDL_Surface			*surf;
 	SDL_Surface			*an_surf;
@@ -33,18 +68,20 @@ void		get_texture(char *name, t_txture *texture, char *path)
 	an_surf = IMG_Load(m);
 	ft_strdel(&m);
 	if (an_surf == NULL)
+	{
+		tex_blank(game, texture);
 		return ;
+	}
 	fmt = malloc_exit(sizeof(SDL_PixelFormat));
 	ft_memcpy(fmt, an_surf->format, sizeof(SDL_PixelFormat));
 	ya_kostil(fmt);
 	surf = SDL_ConvertSurface(an_surf, fmt, an_surf->flags);
 	SDL_FreeSurface(an_surf);
 	ft_memdel((void **)&fmt);
+	texture->format = TEX_ARGB8;
 	texture->width = surf->w;
 	texture->height = surf->h;
-	if (texture->height * texture->width <= 4096 * 2048)
-		ft_memcpy(texture->texture, surf->pixels, (surf->h) * surf->pitch);
-	else
-		exit(0);
+	texture->offset = atlas_push(&game->atlas, surf->pixels,
+	(size_t)surf->w * surf->h);
 	SDL_FreeSurface(surf);
 }
@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/08 17:35:09 by srobert-          #+#    #+#             */
-/*   Updated: 2019/12/13 22:15:57 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/24 15:24:51 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -27,16 +27,6 @@ void	free_list(t_game *game)
 	free(game->normal_list);
 }
 
-void	prepare_data(char ***data, char *line)
-{
-	data[0] = ft_strsplit(line, '\t');
-	if (data[0][1] == NULL)
-	{
-		feel_free(data[0]);
-		data[0] = ft_strsplit(line, ' ');
-	}
-}
-
 void	terminate(char *s)
 {
 	if (errno == 0)
@@ -0,0 +1,73 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   wavefront.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/21 15:32:07 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 19:24:51 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+cl_mem			wavefront_buffer(t_game *game, size_t size, void *host)
+{
+	cl_context	context;
+	cl_mem		mem;
+
+	clGetCommandQueueInfo(game->cl_info->cmd_queue, CL_QUEUE_CONTEXT,
+	sizeof(cl_context), &context, NULL);
+	mem = clCreateBuffer(context, CL_MEM_READ_WRITE |
+	(host ? CL_MEM_COPY_HOST_PTR : 0), size, host, &game->cl_info->ret);
+	if (game->cl_info->ret != CL_SUCCESS)
+		terminate("wavefront buffers do not fit into device memory\n");
+	return (mem);
+}
+
+void			wavefront_kernel(t_game *game, int idx, char *name, int nargs)
+{
+	cl_krl_new_push(&game->cl_info->progs[0], name);
+	cl_krl_init(&game->cl_info->progs[0].krls[idx], nargs);
+	cl_krl_create(game->cl_info, &game->cl_info->progs[0],
+	&game->cl_info->progs[0].krls[idx]);
+}
+
+/*
+** Adapt keeps a second moment and a sample count per pixel, and two
+** lists of the pixels still tracing that swap every launch. Radiance
+** starts zeroed from the host vec_temp, the path state comes from
+** wavefront_views. Every lane of the split gets a set of its own.
+*/
+
+void			wavefront_state(t_game *game)
+{
+	size_t	paths;
+	cl_int	zero[COUNTERS];
+
+	paths = game->frame.cap;
+	ft_bzero(zero, sizeof(zero));
+	game->wf.counters = wavefront_buffer(game, sizeof(zero), zero);
+	game->wf.radiance[0] = wavefront_buffer(game, sizeof(cl_float3) * paths,
+	game->gpu.vec_temp);
+	game->wf.cams = wavefront_buffer(game, sizeof(t_cam) * 2, NULL);
+	game->wf.moment = wavefront_buffer(game, sizeof(cl_float) * paths, NULL);
+	game->wf.spp = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	game->wf.active = wavefront_buffer(game, sizeof(cl_int) * paths * 2, NULL);
+	game->wf.views = 0;
+	wavefront_views(game, 1);
+}
+
+void			wavefront_init(t_game *game)
+{
+	wavefront_kernel(game, WF_GENERATE, "generate_kernel", WF_ARG + 7);
+	wavefront_kernel(game, WF_EXTEND, "extend_kernel", WF_ARG + 7);
+	wavefront_kernel(game, WF_SHADE, "shade_kernel", WF_ARG + 19);
+	wavefront_kernel(game, WF_CONNECT, "connect_kernel", WF_ARG + 7);
+	wavefront_kernel(game, WF_ADAPT, "adapt_kernel", WF_ARG + 6);
+	wavefront_state(game);
+	denoise_init(game);
+	scale_init(game);
+	post_init(game);
+}
@@ -0,0 +1,114 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   wavefront_args.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/21 15:32:07 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 18:10:30 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void		wavefront_arg(t_game *game, int krl, int idx, cl_mem *mem)
+{
+	game->cl_info->ret |= clSetKernelArg(game->cl_info->progs[0].krls[krl].krl,
+	idx, sizeof(cl_mem), mem);
+}
+
+/*
+** Stage arguments start at WF_ARG, below it are the shared scene buffers
+** and the t_wave block at WF_WAVE.
+*/
+
+static void	wave_args_generate(t_game *game, t_wavefront *wf)
+{
+	wavefront_arg(game, WF_GENERATE, WF_ARG, &wf->ray_o);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 1, &wf->ray_d);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 2, &wf->throughput);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 3, &wf->queue[0]);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 4, &wf->counters);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 5, &wf->active);
+	wavefront_arg(game, WF_GENERATE, WF_ARG + 6, &wf->cams);
+	wavefront_arg(game, WF_EXTEND, WF_ARG, &wf->ray_o);
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 1, &wf->ray_d);
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 2, &wf->hit_t);
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 3, &wf->hit_id);
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 4, &wf->hit_prim);
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 6, &wf->counters);
+}
+
+static void	wave_args_shade(t_game *game, t_wavefront *wf)
+{
+	wavefront_arg(game, WF_SHADE, WF_ARG, &wf->ray_o);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 1, &wf->ray_d);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 2, &wf->throughput);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 3, &wf->hit_t);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 4, &wf->hit_id);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 5, &wf->hit_prim);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 8, &wf->counters);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 9, &wf->radiance[0]);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 10, &wf->sh_point);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 11, &wf->sh_dir);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 12, &wf->sh_weight);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 13, &wf->shadow_queue);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 14, &wf->ray_pdf);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 18, &wf->radiance[1]);
+	wavefront_arg(game, WF_CONNECT, WF_ARG, &wf->counters);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 1, &wf->radiance[0]);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 2, &wf->sh_point);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 3, &wf->sh_dir);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 4, &wf->sh_weight);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 5, &wf->shadow_queue);
+	wavefront_arg(game, WF_CONNECT, WF_ARG + 6, &wf->radiance[1]);
+}
+
+/*
+** Path state buffers only move when the views change, they are bound
+** again then. Adapt also reads vect_temp, which belongs to the scene and
+** is bound by wavefront_render.
+*/
+
+void		wavefront_bind(t_game *game)
+{
+	t_wavefront	*wf;
+
+	wf = &game->wf;
+	wave_args_generate(game, wf);
+	wave_args_shade(game, wf);
+	wavefront_arg(game, WF_ADAPT, WF_ARG, &wf->radiance[0]);
+	wavefront_arg(game, WF_ADAPT, WF_ARG + 2, &wf->moment);
+	wavefront_arg(game, WF_ADAPT, WF_ARG + 3, &wf->spp);
+	wavefront_arg(game, WF_ADAPT, WF_ARG + 4, &wf->active);
+	wavefront_arg(game, WF_ADAPT, WF_ARG + 5, &wf->counters);
+}
+
+/*
+** Scene buffers are owned by render_kernel and get reallocated on edits,
+** so every stage borrows them again each frame.
+*/
+
+void		wavefront_bind_scene(t_game *game)
+{
+	t_cl_krl	*owner;
+	int			krl;
+
+	owner = &game->cl_info->progs[0].krls[0];
+	krl = WF_GENERATE - 1;
+	while (++krl <= WF_ADAPT)
+	{
+		wavefront_arg(game, krl, 0, &owner->args[1]);
+		wavefront_arg(game, krl, 1, &owner->args[21]);
+		wavefront_arg(game, krl, 2, &owner->args[3]);
+		wavefront_arg(game, krl, 3, &owner->args[4]);
+		wavefront_arg(game, krl, 4, &owner->args[12]);
+		wavefront_arg(game, krl, 5, &owner->args[13]);
+		wavefront_arg(game, krl, 6, &owner->args[18]);
+		wavefront_arg(game, krl, 7, &owner->args[19]);
+		wavefront_arg(game, krl, 8, &owner->args[20]);
+		wavefront_arg(game, krl, 9, &game->atlas.image);
+		wavefront_arg(game, krl, 10, &owner->args[22]);
+	}
+}
@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   wavefront_run.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/21 15:32:07 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 23:24:31 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** The second dimension is the view, only generate needs it: after that
+** the queues hold the paths of both eyes alike.
+*/
+
+static void	wave_exec(t_game *game, int krl)
+{
+	size_t	global[2];
+
+	global[0] = WAVE_THREADS;
+	global[1] = krl == WF_GENERATE ? game->wf.wave.views : 1;
+	game->cl_info->ret |= clSetKernelArg(game->cl_info->progs[0].krls[krl].krl,
+	WF_WAVE, sizeof(t_wave), &game->wf.wave);
+	krl_exec(game, krl, 2, global);
+}
+
+/*
+** Queues ping-pong between bounces, extend clears the counters shade
+** appends to. Shade queues light samples whenever the scene has lights,
+** in both modes, and connect has to trace them: the bsdf samples that hit
+** a light count for their MIS weight only.
+*/
+
+static void	wave_bounce(t_game *game, t_wavefront *wf)
+{
+	int		in;
+
+	in = wf->wave.bounce & 1;
+	wf->wave.q_in = in;
+	wavefront_arg(game, WF_EXTEND, WF_ARG + 5, &wf->queue[in]);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 6, &wf->queue[in]);
+	wavefront_arg(game, WF_SHADE, WF_ARG + 7, &wf->queue[!in]);
+	wave_exec(game, WF_EXTEND);
+	wave_exec(game, WF_SHADE);
+	if (wf->wave.n_lights)
+		wave_exec(game, WF_CONNECT);
+}
+
+static void	wave_trace(t_game *game, t_wavefront *wf)
+{
+	int		sample;
+
+	sample = -1;
+	while (++sample < SAMPLES)
+	{
+		wf->wave.sample = game->gpu.samples - SAMPLES + sample;
+		wf->wave.bounce = 0;
+		wf->wave.q_in = 0;
+		wave_exec(game, WF_GENERATE);
+		while (wf->wave.bounce < wf->wave.bounces)
+		{
+			wave_bounce(game, wf);
+			wf->wave.bounce++;
+		}
+	}
+}
+
+/*
+** Launch constants of the samples in flight, and the camera of each eye:
+** the second one is shifted sideways.
+*/
+
+void		wavefront_setup(t_game *game, t_wave *wave, t_cam *cams)
+{
+	wave->camera = game->gpu.camera[game->cam_num];
+	wave->n_objects = game->obj_quantity;
+	wave->n_unbounded = game->bvh.unbounded_num;
+	wave->lightsampling = !game->keys.r;
+	wave->global_texture_id = game->global_tex_id;
+	wave->width = game->frame.tw;
+	wave->height = game->frame.th;
+	wave->tile_x = game->frame.x;
+	wave->tile_y = game->frame.y;
+	wave->image_w = game->frame.w;
+	wave->image_h = game->frame.h;
+	wave->bounces = wave->lightsampling ? 1 : game->max_bounces;
+	wave->min_bounces = game->min_bounces;
+	wave->n_lights = game->keys.nee ? game->gpu.lights_num : 0;
+	wave->adaptive = game->keys.adaptive && !wave->camera.stereo;
+	wave->total = game->gpu.samples;
+	wave->seed = game->seed;
+	cams[0] = wave->camera;
+	cams[1] = cams[0];
+	cams[1].position = sum_cfloat3(cams[0].position, cl_scalar_mul(
+	normalize(cross(cams[0].normal, cams[0].direction)), 0.05));
+}
+
+/*
+** Traces SAMPLES paths per pixel and view into the radiance buffers that
+** render_kernel folds into vect_temp and the second eye. The eyes differ
+** in the camera only. Adapt runs in between and picks the pixels the
+** next launch traces.
+*/
+
+void		wavefront_render(t_game *game)
+{
+	t_wavefront	*wf;
+	t_cam		cams[2];
+
+	wf = &game->wf;
+	wavefront_views(game, game->gpu.camera[game->cam_num].stereo == 1 ? 2 : 1);
+	wavefront_bind_scene(game);
+	wavefront_setup(game, &wf->wave, cams);
+	wf->wave.views = wf->views;
+	game->cl_info->ret = cl_write(game->cl_info, wf->cams, sizeof(cams),
+	cams);
+	wave_trace(game, wf);
+	wavefront_arg(game, WF_ADAPT, WF_ARG + 1,
+	&game->cl_info->progs[0].krls[0].args[2]);
+	wave_exec(game, WF_ADAPT);
+	wavefront_arg(game, 0, 10, &wf->eye);
+	wavefront_arg(game, 0, 16, &wf->radiance[0]);
+	wavefront_arg(game, 0, 17, &wf->radiance[1]);
+}
@@ -0,0 +1,83 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   wavefront_views.c                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/27 18:10:30 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/27 18:10:30 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	wave_paths(t_game *game, t_wavefront *wf)
+{
+	size_t	paths;
+
+	paths = game->frame.cap * wf->views;
+	wf->ray_o = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->ray_d = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->throughput = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->sh_point = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->sh_dir = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->sh_weight = wavefront_buffer(game, sizeof(cl_float3) * paths, NULL);
+	wf->hit_t = wavefront_buffer(game, sizeof(cl_float) * paths, NULL);
+	wf->ray_pdf = wavefront_buffer(game, sizeof(cl_float) * paths, NULL);
+	wf->hit_id = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	wf->hit_prim = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	wf->queue[0] = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	wf->queue[1] = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	wf->shadow_queue = wavefront_buffer(game, sizeof(cl_int) * paths, NULL);
+	paths = wf->views > 1 ? game->frame.cap : 1;
+	wf->radiance[1] = wavefront_buffer(game, sizeof(cl_float3) * paths,
+	game->gpu.vec_temp);
+	wf->eye = wavefront_buffer(game, sizeof(cl_float3) * paths,
+	game->gpu.vec_temp);
+}
+
+static void	wave_release(t_wavefront *wf)
+{
+	clReleaseMemObject(wf->ray_o);
+	clReleaseMemObject(wf->ray_d);
+	clReleaseMemObject(wf->throughput);
+	clReleaseMemObject(wf->sh_point);
+	clReleaseMemObject(wf->sh_dir);
+	clReleaseMemObject(wf->sh_weight);
+	clReleaseMemObject(wf->hit_t);
+	clReleaseMemObject(wf->ray_pdf);
+	clReleaseMemObject(wf->hit_id);
+	clReleaseMemObject(wf->hit_prim);
+	clReleaseMemObject(wf->queue[0]);
+	clReleaseMemObject(wf->queue[1]);
+	clReleaseMemObject(wf->shadow_queue);
+	clReleaseMemObject(wf->radiance[1]);
+	clReleaseMemObject(wf->eye);
+}
+
+/*
+** Sizes the path state for the views of the camera, a stereo one traces
+** both eyes in the same launches. Switching starts the accumulation over,
+** called before the launch in flight is set up so it is the first one.
+*/
+
+void		wavefront_views(t_game *game, int views)
+{
+	t_wavefront	*wf;
+
+	wf = &game->wf;
+	if (views == wf->views)
+		return ;
+	if (wf->views)
+	{
+		wave_release(wf);
+		game->gpu.samples = SAMPLES;
+		game->cl_info->ret = cl_write(game->cl_info,
+		game->cl_info->progs[0].krls[0].args[2],
+		sizeof(cl_float3) * game->frame.cap, game->gpu.vec_temp);
+	}
+	wf->views = views;
+	wave_paths(game, wf);
+	wavefront_bind(game);
+}
@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/05 15:13:55 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 15:45:12 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/28 00:49:32 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -23,7 +23,12 @@ void		dump_scene(t_game *game, FILE *fp)
 	fprintf(fp, "        \"cartoon\": %d,\n", cam->cartoon);
 	fprintf(fp, "        \"motion blur\": %.3f,\n", cam->motion_blur);
 	fprintf(fp, "        \"sepia\": %d,\n", cam->sepia);
-	fprintf(fp, "        \"stereo\": %d\n", cam->stereo);
+	fprintf(fp, "        \"stereo\": %d,\n", cam->stereo);
+	fprintf(fp, "        \"denoise\": %d,\n", cam->denoise);
+	fprintf(fp, "        \"min bounces\": %d,\n", game->min_bounces);
+	fprintf(fp, "        \"max bounces\": %d,\n", game->max_bounces);
+	fprintf(fp, "        \"frame time\": %d,\n", game->scale.target);
+	fprintf(fp, "        \"seed\": %u\n", game->seed);
 	fprintf(fp, "    },\n\n");
 }
 
@@ -43,6 +48,8 @@ static void	print_type(int num, FILE *fp)
 		fprintf(fp, "            \"type\": \"torus\",\n");
 	else if (num == PARABOLOID)
 		fprintf(fp, "            \"type\": \"paraboloid\",\n");
+	else if (num == MESH)
+		fprintf(fp, "            \"type\": \"obj3d\",\n");
 }
 
 static void	tex_obj_print(t_obj *obj, FILE *fp, t_game *game)
@@ -73,8 +80,13 @@ static void	tex_obj_print(t_obj *obj, FILE *fp, t_game *game)
 	basis_print(obj, fp);
 }
 
-static void	vert_print(t_obj *obj, FILE *fp)
+static void	vert_print(t_game *game, t_obj *obj, FILE *fp)
 {
+	if (obj->type == MESH)
+	{
+		mesh_print(game, obj, fp);
+		return ;
+	}
 	fprintf(fp, "            \"a\": [%.3f, %.3f, %.3f],\n",
 	obj->vertices[0].s[0], obj->vertices[0].s[1], obj->vertices[0].s[2]);
 	fprintf(fp, "            \"b\": [%.3f, %.3f, %.3f],\n",
@@ -102,10 +114,10 @@ void		dump_obj(t_game *game, FILE *fp)
 		obj->color.s[0], obj->color.s[1], obj->color.s[2]);
 		fprintf(fp, "            \"emition\": [%.3f, %.3f, %.3f],\n",
 		obj->emission.s[0], obj->emission.s[1], obj->emission.s[2]);
-		if (obj->type != TRIANGLE)
+		if (obj->type != TRIANGLE && obj->type != MESH)
 			tex_obj_print(obj, fp, game);
 		else
-			vert_print(obj, fp);
+			vert_print(game, obj, fp);
 		if (i != (int)game->obj_quantity - 1)
 			fprintf(fp, "        },\n");
 	}
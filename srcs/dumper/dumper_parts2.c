@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/05 16:13:54 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 19:00:59 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/24 15:24:51 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -29,6 +29,28 @@ void		basis_print(t_obj *obj, FILE *fp)
 	obj->basis[2].s[0], obj->basis[2].s[1], obj->basis[2].s[2]);
 }
 
+/*
+** Meshes are written back as the obj3d entry they were loaded from.
+*/
+
+void		mesh_print(t_game *game, t_obj *obj, FILE *fp)
+{
+	t_mesh_src	*src;
+	int			i;
+
+	i = -1;
+	while (++i < game->mesh.src_num)
+		if (game->mesh.src[i].root == obj->mesh_root)
+			break ;
+	if (i == game->mesh.src_num)
+		return ;
+	src = &game->mesh.src[i];
+	fprintf(fp, "            \"name\": \"%s\",\n", src->name);
+	fprintf(fp, "            \"size\": %.3f,\n", src->size);
+	fprintf(fp, "            \"position\": [%.3f, %.3f, %.3f]\n",
+	src->position.s[0], src->position.s[1], src->position.s[2]);
+}
+
 void		dump_cam(t_game *game, FILE *fp)
 {
 	int		i;
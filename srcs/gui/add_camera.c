@@ -6,13 +6,13 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/27 17:19:57 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/27 12:20:45 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
-static t_cam	*new_cam(void)
+static t_cam	*new_cam(t_game *game)
 {
 	t_cam		*cam;
 
@@ -26,7 +26,8 @@ static t_cam	*new_cam(void)
 	cam->motion_blur = 0;
 	cam->fov = M_PI / 3;
 	cam->stereo = 0;
-	reconfigure_camera(cam);
+	cam->denoise = 0;
+	reconfigure_camera(game, cam);
 	return (cam);
 }
 
@@ -39,7 +40,7 @@ static void		add_cam_click(KW_Widget *widget, int b)
 	gui = g_gui(0, 0);
 	if (gui->game->ev.button.button != SDL_BUTTON_LEFT)
 		return ;
-	ft_cam_push(gui->game, new_cam());
+	ft_cam_push(gui->game, new_cam(gui->game));
 	cam_free(gui);
 	cam_screen(gui, gui->game);
 	cam_click(gui->c_s.buttons[gui->game->cam_quantity - 1], 0);
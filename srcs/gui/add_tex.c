@@ -6,40 +6,73 @@
 /*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/29 20:53:26 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/03 19:08:39 by lminta           ###   ########.fr       */
+/*   Updated: 2019/12/27 23:02:40 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
-void	push_tex(t_game *game, char *res)
+static void	tex_reload(t_game *game, int arg, size_t size, void *data)
+{
+	t_cl_krl	*krl;
+
+	if (!size)
+		return ;
+	krl = &game->cl_info->progs[0].krls[0];
+	clReleaseMemObject(krl->args[arg]);
+	cl_krl_init_arg(krl, arg, size, data);
+	cl_krl_mem_create(game->cl_info, krl, arg, CL_MEM_READ_WRITE);
+	cl_krl_set_arg(krl, arg);
+	cl_write(game->cl_info, krl->args[arg], size, data);
+}
+
+/*
+** Adding an image repacks the atlas, so both descriptor tables move too.
+*/
+
+static void	textures_reload(t_game *game)
+{
+	atlas_pack(game);
+	tex_reload(game, 3, sizeof(t_txture) * game->textures_num,
+	game->textures);
+	tex_reload(game, 4, sizeof(t_txture) * game->normals_num,
+	game->normals);
+	atlas_upload(game);
+}
+
+void		push_tex(t_game *game, char *res)
 {
 	ft_texture_push(game, &(game->texture_list), res);
 	game->textures =
 	realloc(game->textures, sizeof(t_txture) * game->textures_num);
-	get_texture(res, &(game->textures[game->textures_num - 1]), "./textures/");
-	clReleaseMemObject(game->cl_info->progs[0].krls[0].args[4]);
-	cl_krl_init_arg(&game->cl_info->progs[0].krls[0], 4,
-	sizeof(t_txture) * game->textures_num, game->textures);
-	cl_krl_mem_create(game->cl_info, &game->cl_info->progs[0].krls[0],
-	4, CL_MEM_READ_WRITE);
-	cl_krl_set_arg(&game->cl_info->progs[0].krls[0], 4);
-	cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[4],
-	sizeof(t_txture) * game->textures_num, game->textures);
+	get_texture(game, res, &(game->textures[game->textures_num - 1]),
+	"./textures/");
+	textures_reload(game);
 }
 
-void	push_normal(t_game *game, char *res)
+void		push_normal(t_game *game, char *res)
 {
 	ft_normal_push(game, &(game->normal_list), res);
 	game->normals =
 	realloc(game->normals, sizeof(t_txture) * game->normals_num);
-	get_texture(res, &(game->normals[game->normals_num - 1]), "./normals/");
-	clReleaseMemObject(game->cl_info->progs[0].krls[0].args[5]);
-	cl_krl_init_arg(&game->cl_info->progs[0].krls[0], 5,
-	sizeof(t_txture) * game->normals_num, game->normals);
-	cl_krl_mem_create(game->cl_info, &game->cl_info->progs[0].krls[0],
-	5, CL_MEM_READ_WRITE);
-	cl_krl_set_arg(&game->cl_info->progs[0].krls[0], 5);
-	cl_write(game->cl_info, game->cl_info->progs[0].krls[0].args[5],
-	sizeof(t_txture) * game->normals_num, game->normals);
+	get_texture(game, res, &(game->normals[game->normals_num - 1]),
+	"./normals/");
+	textures_reload(game);
+}
+
+void		textures_init_args(t_game *game)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	atlas_limits(game);
+	atlas_pack(game);
+	cl_krl_init_arg(krl, 3, sizeof(t_txture) * game->textures_num,
+	game->textures);
+	cl_krl_init_arg(krl, 4, sizeof(t_txture) * game->normals_num,
+	game->normals);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 3,
+	CL_MEM_READ_WRITE);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 4,
+	CL_MEM_READ_WRITE);
 }
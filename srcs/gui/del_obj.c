@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/22 21:38:25 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/24 11:31:09 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -32,6 +32,8 @@ void	del_obj(t_obj *obj, t_game *game)
 
 	i = -1;
 	game_buff.gpu.objects = 0;
+	game_buff.obj_quantity = 0;
+	game_buff.obj_cap = 0;
 	while (++i < (int)game->obj_quantity)
 		if ((obj && obj != &game->gpu.objects[i]) ||
 		(!obj && game->gpu.objects[i].is_visible))
@@ -43,6 +45,8 @@ void	del_obj(t_obj *obj, t_game *game)
 	free(game->gpu.objects);
 	game->obj_quantity = game_buff.obj_quantity;
 	game->gpu.objects = game_buff.gpu.objects;
+	game->obj_cap = game_buff.obj_cap;
+	obj_dirty(game, 0, game->obj_quantity - 1);
 	in_cl(game);
 }
 
@@ -0,0 +1,52 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   denoise_gui.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/26 15:48:09 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/26 15:48:09 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	den_name(KW_Widget *widget, t_cam *cam)
+{
+	KW_Widget	*wid;
+
+	wid = KW_GetButtonLabel(widget);
+	if (cam->denoise)
+		KW_SetLabelText(wid, "ON");
+	else
+		KW_SetLabelText(wid, "OFF");
+}
+
+static void	den(KW_Widget *widget, int b)
+{
+	t_gui		*gui;
+	t_cam		*cam;
+
+	b = 0;
+	gui = g_gui(0, 0);
+	if (gui->game->ev.button.button != SDL_BUTTON_LEFT)
+		return ;
+	cam = KW_GetWidgetUserData(widget);
+	cam->denoise = !cam->denoise;
+	den_name(widget, cam);
+}
+
+void		cam_denoise(t_gui *gui, t_cam *cam)
+{
+	gui->c_c.labelrect.y += 30;
+	gui->c_c.editboxrect[0].y += 30;
+	gui->c_c.editboxrect[1].y += 30;
+	gui->c_c.editboxrect[2].y += 30;
+	KW_CreateLabel(gui->gui, gui->c_c.frame, "Denoise", gui->c_c.rects[0]);
+	gui->c_c.buttons[6] = KW_CreateButtonAndLabel(gui->gui,
+	gui->c_c.frame, "test1", gui->c_c.rects[1]);
+	den_name(gui->c_c.buttons[6], cam);
+	KW_AddWidgetMouseDownHandler(gui->c_c.buttons[6], den);
+	KW_SetWidgetUserData(gui->c_c.buttons[6], cam);
+}
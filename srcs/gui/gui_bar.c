@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/10/29 19:10:18 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 19:18:19 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/24 11:31:09 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -23,6 +23,7 @@ void		visibility(KW_Widget *widget, int b)
 		return ;
 	obj = KW_GetWidgetUserData(widget);
 	obj->is_visible = !obj->is_visible;
+	obj_touch(gui->game, obj);
 	visibility_name(widget, obj);
 	gui->flag = 1;
 }
@@ -86,6 +87,7 @@ void		save_click(KW_Widget *widget, int b)
 		hyper_parse(gui, obj);
 	else if (obj->type == TORUS)
 		tor_parse(gui, obj);
+	obj_touch(gui->game, obj);
 	gui->flag = 1;
 }
 
@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/09/13 15:21:19 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/13 19:14:51 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/27 18:10:30 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -34,13 +34,10 @@ static void	rotator(t_game *game)
 		game->flag = 1;
 		game->cl_info->ret =
 		cl_write(game->cl_info, game->cl_info->progs[0].krls->args[2],
-		sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W,\
+		sizeof(cl_float3) * game->frame.cap,\
 		game->gpu.vec_temp);
-		cl_write(game->cl_info, game->cl_info->progs[0].krls->args[11],
-		sizeof(cl_float3) * (unsigned)WIN_H * (unsigned)WIN_W,\
-		game->gpu.vec_temp1);
 		game->gpu.samples = 0;
-		reconfigure_camera(&game->gpu.camera[game->cam_num]);
+		reconfigure_camera(game, &game->gpu.camera[game->cam_num]);
 	}
 }
 
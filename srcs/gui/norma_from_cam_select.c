@@ -6,7 +6,7 @@
 /*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/12 18:24:37 by jblack-b          #+#    #+#             */
-/*   Updated: 2019/12/13 16:24:54 by lminta           ###   ########.fr       */
+/*   Updated: 2019/12/22 11:20:44 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -74,14 +74,14 @@ void		new_mask_push(t_gui *gui, t_cam *cam, int *i)
 	free(gui->game->mask);
 	gui->game->mask = create_blur_mask(cam->motion_blur, &cam->mask_size);
 	gui->game->mask_size = cam->mask_size;
-	clReleaseMemObject(gui->game->cl_info->progs[0].krls[0].args[12]);
-	cl_krl_init_arg(&gui->game->cl_info->progs[0].krls[0], 12,
+	clReleaseMemObject(gui->game->cl_info->progs[0].krls[0].args[11]);
+	cl_krl_init_arg(&gui->game->cl_info->progs[0].krls[0], 11,
 	sizeof(float) * (gui->game->mask_size * 2 + 1) *
 	(gui->game->mask_size * 2 + 1), gui->game->mask);
 	cl_krl_mem_create(gui->game->cl_info, &gui->game->cl_info->progs[0].krls[0],
-	12, CL_MEM_READ_WRITE);
-	cl_krl_set_arg(&gui->game->cl_info->progs[0].krls[0], 12);
+	11, CL_MEM_READ_WRITE);
+	cl_krl_set_arg(&gui->game->cl_info->progs[0].krls[0], 11);
 	cl_write(gui->game->cl_info, gui->game->cl_info->progs[0].krls[0].
-	args[12], sizeof(float) * (gui->game->mask_size * 2 + 1) *
+	args[11], sizeof(float) * (gui->game->mask_size * 2 + 1) *
 	(gui->game->mask_size * 2 + 1), gui->game->mask);
 }
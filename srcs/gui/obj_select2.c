@@ -6,7 +6,7 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/10 23:05:06 by jblack-b          #+#    #+#             */
-/*   Updated: 2019/12/13 19:20:56 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/24 15:24:51 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -31,6 +31,8 @@ static char			*fill_name_mass_switch(t_obj *obj, char *number)
 		res = ft_strjoin("Paraboloid ", number);
 	else if (obj->type == TORUS)
 		res = ft_strjoin("Torus ", number);
+	else if (obj->type == MESH)
+		res = ft_strjoin("Mesh ", number);
 	return (res);
 }
 
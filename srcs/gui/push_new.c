@@ -6,25 +6,23 @@
 /*   By: jblack-b <jblack-b@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/22 15:51:24 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/12 20:14:31 by jblack-b         ###   ########.fr       */
+/*   Updated: 2019/12/24 11:31:09 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
+/*
+** Objects were added or removed: the buttons point into gpu.objects so the
+** list is rebuilt, the device buffer only gets the dirty records.
+*/
+
 void			in_cl(t_game *game)
 {
-	int ret;
-
-	ret = 0;
 	main_screen_free(g_gui(0, 0));
 	main_screen(g_gui(0, 0), game);
-	clReleaseMemObject(game->cl_info->progs[0].krls[0].args[1]);
-	ret = cl_krl_init_arg(&game->cl_info->progs[0].krls[0], 1,
-	game->obj_quantity * sizeof(t_obj), game->gpu.objects);
-	ret = cl_krl_mem_create(game->cl_info, &game->cl_info->progs[0].krls[0], 1,
-	CL_MEM_READ_WRITE);
-	ret = cl_krl_set_arg(&game->cl_info->progs[0].krls[0], 1);
+	game->layout_dirty = 1;
+	obj_flush(game);
 }
 
 void			same_new(t_game *game, t_obj *obj, t_type type)
@@ -45,6 +43,7 @@ void			same_new(t_game *game, t_obj *obj, t_type type)
 	obj->metalness = 0;
 	obj->refraction = 0;
 	ft_object_push(game, obj);
+	obj_dirty(game, game->obj_quantity - 1, game->obj_quantity - 1);
 	in_cl(game);
 }
 
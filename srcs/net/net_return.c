@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/10 21:33:44 by lminta            #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/27 16:42:08 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -61,7 +61,6 @@ static void			serv_side(t_game *game, t_gui *gui, int len, cl_float3 *tmp)
 		all = 0;
 		while (all < len)
 		{
-			current = 0;
 			current = SDLNet_TCP_Recv(gui->n.client[i], buff, 2000);
 			line_create(&tmp_str[all], buff, current);
 			all += current;
@@ -70,7 +69,8 @@ static void			serv_side(t_game *game, t_gui *gui, int len, cl_float3 *tmp)
 	}
 	game->cl_info->ret = cl_write(game->cl_info,
 	game->cl_info->progs[0].krls[0].args[2], len, tmp);
-	ft_run_kernel(game, &game->cl_info->progs[0].krls[0]);
+	ft_display(game);
+	present_flush(game);
 	screen_present(game, gui);
 }
 
@@ -79,7 +79,7 @@ void				net_return(t_game *game, t_gui *gui)
 	int			len;
 	cl_float3	*tmp;
 
-	len = sizeof(cl_float3) * (int)WIN_H * (int)WIN_W;
+	len = sizeof(cl_float3) * game->frame.cap;
 	tmp = fill_tmp(game, len);
 	if (!game->server && gui->n.str_ip)
 		SDLNet_TCP_Send(gui->n.tcpsock, tmp, len);
@@ -0,0 +1,90 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bvh_bounds.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/19 13:02:11 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:31:05 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+t_aabb		aabb_empty(void)
+{
+	t_aabb	box;
+
+	box.min = create_cfloat3(INFINITY, INFINITY, INFINITY);
+	box.max = create_cfloat3(-INFINITY, -INFINITY, -INFINITY);
+	return (box);
+}
+
+void		aabb_grow(t_aabb *box, cl_float3 point)
+{
+	int		i;
+
+	i = -1;
+	while (++i < 3)
+	{
+		box->min.s[i] = fminf(box->min.s[i], point.s[i]);
+		box->max.s[i] = fmaxf(box->max.s[i], point.s[i]);
+	}
+}
+
+void		aabb_merge(t_aabb *box, t_aabb *other)
+{
+	int		i;
+
+	i = -1;
+	while (++i < 3)
+	{
+		box->min.s[i] = fminf(box->min.s[i], other->min.s[i]);
+		box->max.s[i] = fmaxf(box->max.s[i], other->max.s[i]);
+	}
+}
+
+float		aabb_area(t_aabb *box)
+{
+	cl_float3	d;
+
+	if (box->min.s[0] > box->max.s[0])
+		return (0.f);
+	d = vector_diff(box->max, box->min);
+	return (2.f * (d.s[0] * d.s[1] + d.s[1] * d.s[2] + d.s[2] * d.s[0]));
+}
+
+/*
+** Planes, cylinders, cones and paraboloids are infinite, so they stay out
+** of the bvh and get tested linearly by the kernel. A mesh keeps the box
+** of its own tree in vertices[0] and vertices[1].
+*/
+
+int			object_bounds(t_obj *obj, t_aabb *box)
+{
+	float	r;
+
+	*box = aabb_empty();
+	if (obj->type == TRIANGLE)
+	{
+		aabb_grow(box, obj->vertices[0]);
+		aabb_grow(box, obj->vertices[1]);
+		aabb_grow(box, obj->vertices[2]);
+		return (1);
+	}
+	if (obj->type == MESH)
+	{
+		aabb_grow(box, obj->vertices[0]);
+		aabb_grow(box, obj->vertices[1]);
+		return (1);
+	}
+	if (obj->type != SPHERE && obj->type != TORUS)
+		return (0);
+	r = obj->radius;
+	if (obj->type == TORUS)
+		r += obj->tor_radius;
+	aabb_grow(box, sum_cfloat3(obj->position, create_cfloat3(-r, -r, -r)));
+	aabb_grow(box, sum_cfloat3(obj->position, create_cfloat3(r, r, r)));
+	return (1);
+}
@@ -0,0 +1,115 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bvh_build.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/19 13:02:11 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 15:24:51 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static int		bvh_node_push(t_bvh *bvh)
+{
+	if (bvh->nodes_num == bvh->nodes_cap)
+	{
+		bvh->nodes_cap = bvh->nodes_cap ? bvh->nodes_cap * 2 : 64;
+		bvh->nodes = realloc(bvh->nodes, sizeof(t_bvh_node) * bvh->nodes_cap);
+		if (!bvh->nodes)
+			terminate("Malloc ne ok\n");
+	}
+	return (bvh->nodes_num++);
+}
+
+static t_aabb	bvh_node_bounds(t_bvh_build *b, int node, int first, int count)
+{
+	t_aabb	box;
+	int		i;
+
+	box = aabb_empty();
+	b->cbox = aabb_empty();
+	i = first - 1;
+	while (++i < first + count)
+	{
+		aabb_merge(&box, &b->bounds[b->bvh->index[i]]);
+		aabb_grow(&b->cbox, b->centroids[b->bvh->index[i]]);
+	}
+	b->bvh->nodes[node].min = box.min;
+	b->bvh->nodes[node].max = box.max;
+	b->bvh->nodes[node].start = first;
+	b->bvh->nodes[node].count = count;
+	return (box);
+}
+
+/*
+** Nodes are laid out depth first: the left child directly follows its
+** parent, the right one is stored in start and count is -1. Mesh
+** triangles are split by the same code.
+*/
+
+void			bvh_subdivide(t_bvh_build *b, int first, int count, int depth)
+{
+	t_bvh_split	split;
+	t_aabb		box;
+	int			node;
+	int			left;
+
+	node = bvh_node_push(b->bvh);
+	box = bvh_node_bounds(b, node, first, count);
+	if (count <= 1 || depth >= BVH_DEPTH)
+		return ;
+	bvh_find_split(b, &split, first, count);
+	if (split.cost == INFINITY || (count <= BVH_LEAF &&
+	split.cost >= (count - 1) * aabb_area(&box)))
+		return ;
+	left = bvh_partition(b, &split, first, count);
+	if (left == 0 || left == count)
+		left = count / 2;
+	b->bvh->nodes[node].count = -1;
+	bvh_subdivide(b, first, left, depth + 1);
+	b->bvh->nodes[node].start = b->bvh->nodes_num;
+	bvh_subdivide(b, first + left, count - left, depth + 1);
+}
+
+static void		bvh_sort_objects(t_game *game, t_bvh_build *b)
+{
+	int		i;
+	int		bounded;
+
+	i = -1;
+	game->bvh.unbounded_num = 0;
+	while (++i < (int)game->obj_quantity)
+		if (!object_bounds(&game->gpu.objects[i], &b->bounds[i]))
+			game->bvh.index[game->bvh.unbounded_num++] = i;
+	bounded = game->bvh.unbounded_num;
+	i = -1;
+	while (++i < (int)game->obj_quantity)
+		if (b->bounds[i].min.s[0] <= b->bounds[i].max.s[0])
+		{
+			b->centroids[i] = mult_cfloat3(sum_cfloat3(b->bounds[i].min,
+			b->bounds[i].max), 0.5f);
+			game->bvh.index[bounded++] = i;
+		}
+}
+
+void			build_bvh(t_game *game)
+{
+	t_bvh_build	b;
+
+	game->bvh.nodes_num = 0;
+	game->bvh.index = realloc(game->bvh.index,
+	sizeof(cl_int) * (game->obj_quantity + 1));
+	b.bounds = malloc_exit(sizeof(t_aabb) * (game->obj_quantity + 1));
+	b.centroids = malloc_exit(sizeof(cl_float3) * (game->obj_quantity + 1));
+	if (!game->bvh.index)
+		terminate("Malloc ne ok\n");
+	b.bvh = &game->bvh;
+	bvh_sort_objects(game, &b);
+	bvh_subdivide(&b, game->bvh.unbounded_num,
+	game->obj_quantity - game->bvh.unbounded_num, 0);
+	free(b.bounds);
+	free(b.centroids);
+}
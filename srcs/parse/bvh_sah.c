@@ -0,0 +1,129 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bvh_sah.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/19 13:02:11 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/19 13:02:11 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+int			bvh_bin_of(t_bvh_split *split, float centroid)
+{
+	int		bin;
+
+	bin = (int)((centroid - split->cmin) * split->scale);
+	if (bin < 0)
+		return (0);
+	return (bin >= BVH_BINS ? BVH_BINS - 1 : bin);
+}
+
+static void	bins_fill(t_bvh_build *b, t_bvh_split *split, int first, int count)
+{
+	int		i;
+	int		bin;
+	int		obj;
+
+	i = -1;
+	while (++i < BVH_BINS)
+	{
+		split->bins[i].box = aabb_empty();
+		split->bins[i].count = 0;
+	}
+	i = first - 1;
+	while (++i < first + count)
+	{
+		obj = b->bvh->index[i];
+		bin = bvh_bin_of(split, b->centroids[obj].s[split->axis]);
+		split->bins[bin].count++;
+		aabb_merge(&split->bins[bin].box, &b->bounds[obj]);
+	}
+}
+
+static void	bins_sweep(t_bvh_split *split, float *cost)
+{
+	t_aabb	box;
+	int		i;
+	int		n;
+
+	box = aabb_empty();
+	n = 0;
+	i = -1;
+	while (++i < BVH_BINS - 1)
+	{
+		aabb_merge(&box, &split->bins[i].box);
+		n += split->bins[i].count;
+		cost[i] = n * aabb_area(&box);
+	}
+	box = aabb_empty();
+	n = 0;
+	while (--i >= 0)
+	{
+		aabb_merge(&box, &split->bins[i + 1].box);
+		n += split->bins[i + 1].count;
+		cost[i] += n * aabb_area(&box);
+	}
+}
+
+/*
+** Binned SAH: centroids are bucketed along every axis and the cheapest
+** bucket border wins. The cost is left unnormalized (area * count).
+*/
+
+void		bvh_find_split(t_bvh_build *b, t_bvh_split *best, int first,\
+int count)
+{
+	t_bvh_split	split;
+	float		cost[BVH_BINS - 1];
+	float		extent;
+	int			i;
+
+	best->cost = INFINITY;
+	split.axis = -1;
+	while (++split.axis < 3)
+	{
+		split.cmin = b->cbox.min.s[split.axis];
+		extent = b->cbox.max.s[split.axis] - split.cmin;
+		if (extent < 1e-6f)
+			continue ;
+		split.scale = BVH_BINS / extent;
+		bins_fill(b, &split, first, count);
+		bins_sweep(&split, cost);
+		i = -1;
+		while (++i < BVH_BINS - 1)
+			if (cost[i] < best->cost)
+			{
+				*best = split;
+				best->bin = i;
+				best->cost = cost[i];
+			}
+	}
+}
+
+int			bvh_partition(t_bvh_build *b, t_bvh_split *split, int first,\
+int count)
+{
+	int		i;
+	int		j;
+	cl_int	tmp;
+
+	i = first;
+	j = first + count - 1;
+	while (i <= j)
+	{
+		if (bvh_bin_of(split, b->centroids[b->bvh->index[i]].s[split->axis])\
+		<= split->bin)
+			i++;
+		else
+		{
+			tmp = b->bvh->index[i];
+			b->bvh->index[i] = b->bvh->index[j];
+			b->bvh->index[j--] = tmp;
+		}
+	}
+	return (i - first);
+}
@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bvh_upload.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/19 13:02:11 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 11:31:09 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	bvh_mem_create(t_game *game, int arg, size_t size, void *data)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	clReleaseMemObject(krl->args[arg]);
+	cl_krl_init_arg(krl, arg, size, data);
+	cl_krl_mem_create(game->cl_info, krl, arg, CL_MEM_READ_ONLY);
+	cl_krl_set_arg(krl, arg);
+	cl_write(game->cl_info, krl->args[arg], size, data);
+}
+
+void		bvh_init_args(t_game *game)
+{
+	t_cl_krl	*krl;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	cl_krl_init_arg(krl, 12, sizeof(t_bvh_node) * game->bvh.nodes_num,
+	game->bvh.nodes);
+	cl_krl_init_arg(krl, 13, sizeof(cl_int) * (game->obj_quantity + 1),
+	game->bvh.index);
+	cl_krl_init_arg(krl, 14, sizeof(cl_int), &game->bvh.unbounded_num);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 12,
+	CL_MEM_READ_ONLY);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 13,
+	CL_MEM_READ_ONLY);
+}
+
+/*
+** Recomputes the boxes bottom-up, children always come after their parent.
+** Fails when an object moved between the bounded and unbounded sets.
+*/
+
+static int	bvh_refit_node(t_game *game, t_bvh_node *nodes, int i)
+{
+	t_aabb	box;
+	t_aabb	obj;
+	int		j;
+
+	box = aabb_empty();
+	if (nodes[i].count < 0)
+	{
+		obj.min = nodes[i + 1].min;
+		obj.max = nodes[i + 1].max;
+		aabb_merge(&box, &obj);
+		obj.min = nodes[nodes[i].start].min;
+		obj.max = nodes[nodes[i].start].max;
+		aabb_merge(&box, &obj);
+	}
+	j = nodes[i].start - 1;
+	while (nodes[i].count >= 0 && ++j < nodes[i].start + nodes[i].count)
+	{
+		if (!object_bounds(&game->gpu.objects[game->bvh.index[j]], &obj))
+			return (0);
+		aabb_merge(&box, &obj);
+	}
+	nodes[i].min = box.min;
+	nodes[i].max = box.max;
+	return (1);
+}
+
+/*
+** Edits that keep the object set only refit the existing tree, which is
+** linear and leaves the node and index buffers where they are.
+*/
+
+void		bvh_refit(t_game *game)
+{
+	t_aabb	obj;
+	int		i;
+
+	i = -1;
+	while (++i < game->bvh.unbounded_num)
+		if (object_bounds(&game->gpu.objects[game->bvh.index[i]], &obj))
+		{
+			bvh_upload(game);
+			return ;
+		}
+	i = game->bvh.nodes_num;
+	while (--i >= 0)
+		if (!bvh_refit_node(game, game->bvh.nodes, i))
+		{
+			bvh_upload(game);
+			return ;
+		}
+	game->cl_info->ret = cl_write(game->cl_info,
+	game->cl_info->progs[0].krls[0].args[12],
+	sizeof(t_bvh_node) * game->bvh.nodes_num, game->bvh.nodes);
+}
+
+void		bvh_upload(t_game *game)
+{
+	build_bvh(game);
+	bvh_mem_create(game, 12, sizeof(t_bvh_node) * game->bvh.nodes_num,
+	game->bvh.nodes);
+	bvh_mem_create(game, 13, sizeof(cl_int) * (game->obj_quantity + 1),
+	game->bvh.index);
+}
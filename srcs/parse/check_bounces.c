@@ -0,0 +1,42 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   check_bounces.c                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/25 17:20:06 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:53:40 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static int	bounce_item(cJSON *scene, char *name, int def)
+{
+	cJSON	*item;
+
+	item = scene ? cJSON_GetObjectItemCaseSensitive(scene, name) : NULL;
+	if (item == NULL || !cJSON_IsNumber(item))
+		return (def);
+	return ((int)item->valuedouble);
+}
+
+/*
+** Paths always run min bounces, after that russian roulette ends them
+** depending on their throughput, max is the hard limit for both.
+*/
+
+void		check_bounces(cJSON *scene, t_game *game)
+{
+	game->max_bounces = bounce_item(scene, "max bounces", BOUNCES);
+	if (game->max_bounces < 1)
+		game->max_bounces = 1;
+	if (game->max_bounces > MAX_BOUNCES)
+		game->max_bounces = MAX_BOUNCES;
+	game->min_bounces = bounce_item(scene, "min bounces", MIN_BOUNCES);
+	if (game->min_bounces < 1)
+		game->min_bounces = 1;
+	if (game->min_bounces > game->max_bounces)
+		game->min_bounces = game->max_bounces;
+}
@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/06 20:32:27 by srobert-          #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/27 12:20:45 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -49,9 +49,10 @@ void		check_cam(t_json parse, t_game *game, t_filter *filter)
 	camera->sepia = filter->sepia;
 	camera->motion_blur = filter->motion_blur;
 	camera->stereo = filter->stereo;
+	camera->denoise = filter->denoise;
 	ft_memdel((void **)&game->mask);
 	game->mask = create_blur_mask(camera->motion_blur, &camera->mask_size);
 	game->mask_size = camera->mask_size;
-	reconfigure_camera(camera);
+	reconfigure_camera(game, camera);
 	ft_cam_push(game, camera);
 }
@@ -0,0 +1,30 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   check_frame_time.c                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/28 00:53:40 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/28 00:53:40 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** What the window aims for in ms while the view changes, it traces at a
+** smaller size to keep under it. 0 always renders the full size.
+*/
+
+void		check_frame_time(cJSON *scene, t_game *game)
+{
+	cJSON	*item;
+
+	item = scene ? cJSON_GetObjectItemCaseSensitive(scene, "frame time") :
+	NULL;
+	game->scale.target = item != NULL && cJSON_IsNumber(item) ?
+	(int)item->valuedouble : SCALE_TARGET;
+	if (game->scale.target < 0)
+		game->scale.target = 0;
+}
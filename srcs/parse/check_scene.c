@@ -6,7 +6,7 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/06 19:16:12 by srobert-          #+#    #+#             */
-/*   Updated: 2019/12/13 21:47:15 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/28 00:53:40 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -57,6 +57,9 @@ static t_filter	check_filter(cJSON *scene, t_json parse)
 	parse.stereo = cJSON_GetObjectItemCaseSensitive(scene, "stereo");
 	filter.stereo = parse.stereo != NULL ? \
 	(int)parse.stereo->valuedouble : 0;
+	parse.denoise = cJSON_GetObjectItemCaseSensitive(scene, "denoise");
+	filter.denoise = parse.denoise != NULL ? \
+	(int)parse.denoise->valuedouble : 0;
 	parse.motion_blur = cJSON_GetObjectItemCaseSensitive(scene, "motion blur");
 	filter.motion_blur = parse.motion_blur != NULL ? \
 	parse.motion_blur->valuedouble : 0;
@@ -71,6 +74,7 @@ static t_filter	filter_default(void)
 	filter.cartoon = 0;
 	filter.sepia = 0;
 	filter.stereo = 0;
+	filter.denoise = 0;
 	filter.motion_blur = 0;
 	return (filter);
 }
@@ -82,15 +86,12 @@ void			check_scene(t_json parse, t_game *game)
 
 	scene = cJSON_GetObjectItemCaseSensitive(parse.json, "scene");
 	if (scene != NULL)
-	{
 		check_global_tex(scene, game);
-		filter = check_filter(scene, parse);
-	}
 	else
-	{
 		set_default_tex(game);
-		filter = filter_default();
-	}
+	filter = scene != NULL ? check_filter(scene, parse) : filter_default();
+	check_bounces(scene, game);
+	check_frame_time(scene, game);
 	parse.music = cJSON_GetObjectItemCaseSensitive(scene, "music");
 	if (parse.music != NULL && parse.music->valuestring != NULL)
 		game->music = ft_strdup(parse.music->valuestring);
@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mesh_build.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/24 15:06:12 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 15:06:12 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+static void	mesh_bounds(t_game *game, t_obj_file *f, t_bvh_build *b,
+			int count)
+{
+	t_tri	*tri;
+	int		i;
+	int		k;
+
+	i = -1;
+	while (++i < count)
+	{
+		tri = &game->mesh.tris[f->first + i];
+		b->bounds[i] = aabb_empty();
+		k = -1;
+		while (++k < 3)
+			aabb_grow(&b->bounds[i], game->mesh.data[tri->v[k]]);
+		b->centroids[i] = mult_cfloat3(sum_cfloat3(b->bounds[i].min,
+		b->bounds[i].max), 0.5f);
+		b->bvh->index[i] = i;
+	}
+}
+
+/*
+** Leaves address the triangle list directly, so it is put in leaf order.
+*/
+
+static void	mesh_reorder(t_game *game, t_obj_file *f, t_bvh *tree,
+			int count)
+{
+	t_tri	*sorted;
+	int		i;
+
+	sorted = (t_tri*)malloc_exit(sizeof(t_tri) * count);
+	i = -1;
+	while (++i < count)
+		sorted[i] = game->mesh.tris[f->first + tree->index[i]];
+	ft_memcpy(game->mesh.tris + f->first, sorted, sizeof(t_tri) * count);
+	free(sorted);
+}
+
+static int	mesh_nodes(t_game *game, t_obj_file *f, t_bvh *tree)
+{
+	t_bvh	*all;
+	int		root;
+	int		i;
+
+	all = &game->mesh.bvh;
+	root = all->nodes_num;
+	all->nodes = mesh_grow(all->nodes, &all->nodes_cap,
+	root + tree->nodes_num, sizeof(t_bvh_node));
+	i = -1;
+	while (++i < tree->nodes_num)
+	{
+		all->nodes[root + i] = tree->nodes[i];
+		all->nodes[root + i].start += tree->nodes[i].count < 0 ?
+		root : f->first;
+	}
+	all->nodes_num += tree->nodes_num;
+	return (root);
+}
+
+/*
+** The mesh box is kept in the vertices so the scene bvh treats the object
+** like a big triangle, the source is remembered for the dumper.
+*/
+
+static void	mesh_object(t_game *game, t_obj_file *f, int root, char *name)
+{
+	t_obj		*obj;
+	t_mesh_src	*src;
+
+	obj = (t_obj*)malloc_exit(sizeof(t_obj));
+	ft_bzero(obj, sizeof(t_obj));
+	obj->type = MESH;
+	obj->vertices[0] = game->mesh.bvh.nodes[root].min;
+	obj->vertices[1] = game->mesh.bvh.nodes[root].max;
+	obj->vertices[2] = obj->vertices[1];
+	set_default_triangle(obj);
+	obj->v = create_cfloat3(0, 0, 1);
+	obj->mesh_root = root;
+	ft_object_push(game, obj);
+	game->mesh.src = realloc(game->mesh.src,
+	sizeof(t_mesh_src) * (game->mesh.src_num + 1));
+	if (!game->mesh.src)
+		terminate("Malloc ne ok\n");
+	src = &game->mesh.src[game->mesh.src_num++];
+	src->name = ft_strdup(name);
+	src->size = f->size;
+	src->position = f->shift;
+	src->root = root;
+}
+
+void		mesh_build(t_game *game, t_obj_file *f, char *name)
+{
+	t_bvh_build	b;
+	t_bvh		tree;
+	int			count;
+
+	count = game->mesh.tris_num - f->first;
+	if (count <= 0)
+		return ;
+	ft_bzero(&tree, sizeof(t_bvh));
+	tree.index = (cl_int*)malloc_exit(sizeof(cl_int) * count);
+	b.bounds = (t_aabb*)malloc_exit(sizeof(t_aabb) * count);
+	b.centroids = (cl_float3*)malloc_exit(sizeof(cl_float3) * count);
+	b.bvh = &tree;
+	mesh_bounds(game, f, &b, count);
+	bvh_subdivide(&b, 0, count, 0);
+	mesh_reorder(game, f, &tree, count);
+	mesh_object(game, f, mesh_nodes(game, f, &tree), name);
+	free(tree.index);
+	free(tree.nodes);
+	free(b.bounds);
+	free(b.centroids);
+}
@@ -0,0 +1,113 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   mesh_upload.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/24 14:48:33 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 14:48:33 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Makes room for element num, growing by doubling.
+*/
+
+void		*mesh_grow(void *ptr, int *cap, int num, size_t size)
+{
+	if (num < *cap)
+		return (ptr);
+	while (*cap <= num)
+		*cap = *cap ? *cap * 2 : MESH_CHUNK;
+	ptr = realloc(ptr, size * *cap);
+	if (!ptr)
+		terminate("Malloc ne ok\n");
+	return (ptr);
+}
+
+void		mesh_reset(t_game *game)
+{
+	t_mesh	*m;
+
+	m = &game->mesh;
+	while (m->src_num > 0)
+		free(m->src[--m->src_num].name);
+	m->data_num = 0;
+	m->tris_num = 0;
+	m->bvh.nodes_num = 0;
+	m->data = mesh_grow(m->data, &m->data_cap, 0, sizeof(cl_float3));
+	m->tris = mesh_grow(m->tris, &m->tris_cap, 0, sizeof(t_tri));
+	m->bvh.nodes = mesh_grow(m->bvh.nodes, &m->bvh.nodes_cap, 0,
+	sizeof(t_bvh_node));
+}
+
+static void	mesh_fixup(t_mesh *m, int first, int *base)
+{
+	int		i;
+	int		k;
+
+	i = first - 1;
+	while (++i < m->tris_num)
+	{
+		k = -1;
+		while (++k < 3)
+		{
+			m->tris[i].v[k] += base[0];
+			if (m->tris[i].n[k] >= 0)
+				m->tris[i].n[k] += base[1];
+			if (m->tris[i].t[k] >= 0)
+				m->tris[i].t[k] += base[2];
+		}
+	}
+}
+
+/*
+** Positions, normals and uvs of the file go to the end of the shared data
+** array, its faces are rebased from file local to global indices.
+*/
+
+void		mesh_append(t_game *game, t_obj_file *f)
+{
+	t_mesh	*m;
+	int		base[3];
+	int		k;
+
+	m = &game->mesh;
+	k = -1;
+	while (++k < 3)
+	{
+		base[k] = m->data_num;
+		m->data = mesh_grow(m->data, &m->data_cap, m->data_num + f->num[k],
+		sizeof(cl_float3));
+		if (f->num[k])
+			ft_memcpy(m->data + m->data_num, f->v[k],
+			sizeof(cl_float3) * f->num[k]);
+		m->data_num += f->num[k];
+		free(f->v[k]);
+	}
+	mesh_fixup(m, f->first, base);
+}
+
+void		mesh_init_args(t_game *game)
+{
+	t_cl_krl	*krl;
+	t_mesh		*m;
+
+	krl = &game->cl_info->progs[0].krls[0];
+	m = &game->mesh;
+	cl_krl_init_arg(krl, 18, sizeof(cl_float3) *
+	(m->data_num ? m->data_num : 1), m->data);
+	cl_krl_init_arg(krl, 19, sizeof(t_tri) *
+	(m->tris_num ? m->tris_num : 1), m->tris);
+	cl_krl_init_arg(krl, 20, sizeof(t_bvh_node) *
+	(m->bvh.nodes_num ? m->bvh.nodes_num : 1), m->bvh.nodes);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 18,
+	CL_MEM_READ_ONLY);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 19,
+	CL_MEM_READ_ONLY);
+	game->cl_info->ret = cl_krl_mem_create(game->cl_info, krl, 20,
+	CL_MEM_READ_ONLY);
+}
@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   obj3d_face.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/24 14:19:42 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 14:19:42 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+/*
+** Obj indices start at 1, negative ones count back from the last element
+** read so far.
+*/
+
+static int	obj_index(t_obj_file *f, int value, int kind)
+{
+	if (value < 0)
+		value += f->num[kind];
+	else
+		value -= 1;
+	if (value < 0 || value >= f->num[kind])
+		terminate("zochem ti slomal .obj file?");
+	return (value);
+}
+
+/*
+** Reads one of v, v/vt, v//vn or v/vt/vn into position, normal and uv.
+*/
+
+static int	obj_ref(t_obj_file *f, int *ref)
+{
+	int		value;
+
+	obj_skip(f);
+	ref[0] = -1;
+	ref[1] = -1;
+	ref[2] = -1;
+	if (!obj_int(f, &value))
+		return (0);
+	ref[0] = obj_index(f, value, 0);
+	if (f->p < f->end && *f->p == '/' && ++f->p && obj_int(f, &value))
+		ref[2] = obj_index(f, value, 2);
+	if (f->p < f->end && *f->p == '/' && ++f->p && obj_int(f, &value))
+		ref[1] = obj_index(f, value, 1);
+	return (1);
+}
+
+static void	obj_tri_push(t_game *game, int ref[3][3])
+{
+	t_tri	*tri;
+	int		k;
+
+	game->mesh.tris = mesh_grow(game->mesh.tris, &game->mesh.tris_cap,
+	game->mesh.tris_num, sizeof(t_tri));
+	tri = &game->mesh.tris[game->mesh.tris_num++];
+	k = -1;
+	while (++k < 3)
+	{
+		tri->v[k] = ref[k][0];
+		tri->n[k] = ref[k][1];
+		tri->t[k] = ref[k][2];
+	}
+}
+
+/*
+** Quads and larger polygons are split into a fan around their first
+** corner, which is exact for the convex faces exporters write.
+*/
+
+void		obj_face(t_obj_file *f, t_game *game)
+{
+	int		ref[3][3];
+	int		i;
+
+	if (!obj_ref(f, ref[0]) || !obj_ref(f, ref[1]))
+		terminate("zochem ti slomal .obj file?");
+	while (obj_ref(f, ref[2]))
+	{
+		obj_tri_push(game, ref);
+		i = -1;
+		while (++i < 3)
+			ref[1][i] = ref[2][i];
+	}
+}
@@ -6,97 +6,109 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/11/18 20:17:38 by srobert-          #+#    #+#             */
-/*   Updated: 2019/12/14 18:46:07 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/24 14:31:05 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
-void		ft_vert_push(t_game *game, cl_float3 vert)
+static char	*obj_map(cJSON *name, size_t *len)
 {
-	if (game->vertices_list == NULL)
-		game->vertices_num = 0;
-	game->vertices_list = realloc(game->vertices_list,
-	sizeof(cl_float3) * (game->vertices_num + 1));
-	game->vertices_list[game->vertices_num] = vert;
-	game->vertices_num += 1;
+	struct stat	st;
+	char		*path;
+	char		*map;
+	int			fd;
+
+	if (name == NULL || name->valuestring == NULL)
+		terminate("name of obj3d is govno\n");
+	path = ft_strjoin("./obj3d/", name->valuestring);
+	if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+		terminate("No file\n");
+	free(path);
+	*len = st.st_size;
+	map = *len ? mmap(NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close(fd);
+	if (map == MAP_FAILED)
+		terminate("No file\n");
+	return (map);
 }
 
-static void	parse_vertice(char **data, t_game *game, t_json *parse, \
-														const cJSON *object)
+static int	obj_tag(t_obj_file *f, char *tag)
 {
-	cl_float3 vert;
+	size_t	len;
 
-	parse->size = cJSON_GetObjectItemCaseSensitive(object, "size");
-	if (data[1] == NULL || data[2] == NULL || data[3] == NULL)
-		terminate("zochem ti slomal .obj file?");
-	vert = create_cfloat3(atof(data[1]) * parse->size->valuedouble, \
-							atof(data[2]) * parse->size->valuedouble, \
-							atof(data[3]) * parse->size->valuedouble);
-	ft_vert_push(game, vert);
+	len = ft_strlen(tag);
+	if ((size_t)(f->end - f->p) <= len || ft_strncmp(f->p, tag, len) ||
+	(f->p[len] != ' ' && f->p[len] != '\t'))
+		return (0);
+	f->p += len;
+	return (1);
 }
 
-static void	push_facing(char **data, t_game *game, t_json *parse, \
-															const cJSON *object)
+/*
+** Positions are scaled and moved into the scene right away, uvs keep
+** their optional third coordinate out.
+*/
+
+static void	obj_vertex(t_obj_file *f, int kind)
 {
-	t_obj		*obj;
-	cl_float3	shift;
-	int			num[4];
+	cl_float3	*v;
 
-	num[3] = game->vertices_num;
-	obj = (t_obj*)malloc_exit(sizeof(t_obj));
-	parse->composed_pos = cJSON_GetObjectItemCaseSensitive(object, "position");
-	shift = parse_vec3(parse->composed_pos, 0);
-	obj->type = TRIANGLE;
-	if (data[1] == NULL || data[2] == NULL || data[3] == NULL)
-		terminate("zochem ti slomal .obj file?");
-	num[0] = ft_atoi(data[1]) > 0 ? ft_atoi(data[1]) : -ft_atoi(data[1]);
-	num[1] = ft_atoi(data[2]) > 0 ? ft_atoi(data[2]) : -ft_atoi(data[2]);
-	num[2] = ft_atoi(data[3]) > 0 ? ft_atoi(data[3]) : -ft_atoi(data[3]);
-	if (num[0] > num[3] || num[1] > num[3] || num[2] > num[3])
-		terminate("zochem ti slomal .obj file?");
-	obj->vertices[0] = sum_cfloat3(game->vertices_list[num[0] - 1], shift);
-	obj->vertices[1] = sum_cfloat3(game->vertices_list[num[1] - 1], shift);
-	obj->vertices[2] = sum_cfloat3(game->vertices_list[num[2] - 1], shift);
-	set_default_triangle(obj);
-	ft_object_push(game, obj);
+	f->v[kind] = mesh_grow(f->v[kind], &f->cap[kind], f->num[kind],
+	sizeof(cl_float3));
+	v = &f->v[kind][f->num[kind]++];
+	v->s[0] = obj_float(f);
+	v->s[1] = obj_float(f);
+	v->s[2] = kind == 2 ? 0.f : obj_float(f);
+	if (kind == 0)
+		*v = sum_cfloat3(mult_cfloat3(*v, f->size), f->shift);
+	else if (kind == 1 && vec_len(*v) > 0.f)
+		*v = normalize(*v);
 }
 
-static void	hate_norm(const cJSON *object, t_game *game, t_json *parse, \
-																	char **data)
+static void	obj_line(t_obj_file *f, t_game *game)
 {
-	if (ft_strcmp(data[0], "v") == 0)
-		parse_vertice(data, game, parse, object);
-	if (ft_strcmp(data[0], "f") == 0)
-		push_facing(data, game, parse, object);
-	feel_free(data);
+	obj_skip(f);
+	if (obj_tag(f, "v"))
+		obj_vertex(f, 0);
+	else if (obj_tag(f, "vn"))
+		obj_vertex(f, 1);
+	else if (obj_tag(f, "vt"))
+		obj_vertex(f, 2);
+	else if (obj_tag(f, "f"))
+		obj_face(f, game);
 }
 
+/*
+** The whole file is mapped and scanned once, faces land in the shared
+** triangle list and become a single mesh object with its own bvh.
+*/
+
 void		obj3d_parse(const cJSON *object, t_game *game, t_json *parse)
 {
-	int		fd;
-	char	*line;
-	char	**data;
-	char	*m;
+	t_obj_file	f;
+	char		*map;
+	size_t		len;
 
 	parse->name = cJSON_GetObjectItemCaseSensitive(object, "name");
-	if (parse->name == NULL || parse->name->valuestring == NULL)
-		terminate("name of obj3d is govno\n");
-	m = ft_strjoin("./obj3d/", parse->name->valuestring);
-	if ((fd = open(m, O_RDONLY)) <= 0)
-		terminate("No file\n");
-	free(m);
-	while (get_next_line(fd, &line) > 0)
+	map = obj_map(parse->name, &len);
+	ft_bzero(&f, sizeof(t_obj_file));
+	parse->size = cJSON_GetObjectItemCaseSensitive(object, "size");
+	f.size = parse->size != NULL ? parse->size->valuedouble : 1.f;
+	parse->composed_pos = cJSON_GetObjectItemCaseSensitive(object, "position");
+	f.shift = parse_vec3(parse->composed_pos, 0);
+	if (isnan(f.shift.s[0]))
+		f.shift = create_cfloat3(0, 0, 0);
+	f.first = game->mesh.tris_num;
+	f.p = map;
+	f.end = map + len;
+	while (f.p < f.end)
 	{
-		if (ft_strlen(line) == 0)
-		{
-			free(line);
-			continue;
-		}
-		prepare_data(&data, line);
-		hate_norm(object, game, parse, data);
-		free(line);
+		obj_line(&f, game);
+		obj_eol(&f);
 	}
-	free(line);
-	close(fd);
+	if (map)
+		munmap(map, len);
+	mesh_append(game, &f);
+	mesh_build(game, &f, parse->name->valuestring);
 }
@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   obj3d_scan.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: lminta <lminta@student.21-school.ru>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2019/12/24 14:02:17 by lminta            #+#    #+#             */
+/*   Updated: 2019/12/24 14:02:17 by lminta           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "rt.h"
+
+void			obj_skip(t_obj_file *f)
+{
+	while (f->p < f->end && (*f->p == ' ' || *f->p == '\t' || *f->p == '\r'))
+		f->p++;
+}
+
+/*
+** Moves past the rest of the line, comments and unknown tags included.
+*/
+
+int				obj_eol(t_obj_file *f)
+{
+	while (f->p < f->end && *f->p != '\n')
+		f->p++;
+	if (f->p < f->end)
+		f->p++;
+	return (f->p < f->end);
+}
+
+static double	obj_exponent(t_obj_file *f)
+{
+	int		e;
+	int		sign;
+
+	e = 0;
+	sign = 1;
+	if (f->p < f->end && (*f->p == 'e' || *f->p == 'E'))
+	{
+		f->p++;
+		if (f->p < f->end && (*f->p == '-' || *f->p == '+'))
+			sign = *f->p++ == '-' ? -1 : 1;
+		while (f->p < f->end && ft_isdigit(*f->p))
+			e = e * 10 + (*f->p++ - '0');
+	}
+	return (e ? pow(10.0, sign * e) : 1.0);
+}
+
+/*
+** Hand written replacement for atof, the mapping is not null terminated
+** and strtod would also pay for locale lookups on every number.
+*/
+
+float			obj_float(t_obj_file *f)
+{
+	double	res;
+	double	scale;
+	int		sign;
+
+	obj_skip(f);
+	sign = 1;
+	if (f->p < f->end && (*f->p == '-' || *f->p == '+'))
+		sign = *f->p++ == '-' ? -1 : 1;
+	res = 0.0;
+	while (f->p < f->end && ft_isdigit(*f->p))
+		res = res * 10.0 + (*f->p++ - '0');
+	scale = 0.1;
+	if (f->p < f->end && *f->p == '.')
+		while (++f->p < f->end && ft_isdigit(*f->p))
+		{
+			res += (*f->p - '0') * scale;
+			scale *= 0.1;
+		}
+	return ((float)(sign * res * obj_exponent(f)));
+}
+
+/*
+** Returns 0 when there is no number at the cursor.
+*/
+
+int				obj_int(t_obj_file *f, int *value)
+{
+	int		sign;
+	char	*start;
+
+	sign = 1;
+	if (f->p < f->end && *f->p == '-')
+	{
+		sign = -1;
+		f->p++;
+	}
+	start = f->p;
+	*value = 0;
+	while (f->p < f->end && ft_isdigit(*f->p))
+		*value = *value * 10 + (*f->p++ - '0');
+	*value *= sign;
+	return (f->p != start);
+}
@@ -6,12 +6,27 @@
 /*   By: srobert- <srobert-@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2019/12/06 18:07:07 by srobert-          #+#    #+#             */
-/*   Updated: 2019/12/14 18:50:44 by srobert-         ###   ########.fr       */
+/*   Updated: 2019/12/24 15:24:51 by lminta           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "rt.h"
 
+/*
+** Render settings of the "scene" block, a fixed seed keeps frames
+** reproducible across runs.
+*/
+
+static void		check_render(t_json json, t_game *game)
+{
+	cJSON	*scene;
+	cJSON	*seed;
+
+	scene = cJSON_GetObjectItemCaseSensitive(json.json, "scene");
+	seed = cJSON_GetObjectItemCaseSensitive(scene, "seed");
+	game->seed = seed != NULL ? (cl_uint)seed->valuedouble : 0;
+}
+
 static t_json	prepare_scene(char *argv, t_game *game)
 {
 	FILE	*fp;
@@ -32,6 +47,8 @@ please check that commas on right positions\n");
 	json.objects = NULL;
 	free(game->textures);
 	free(game->normals);
+	game->atlas.size = 0;
+	mesh_reset(game);
 	return (json);
 }
 
@@ -43,6 +60,7 @@ void			read_scene(char *argv, t_game *game)
 	id = 0;
 	json = prepare_scene(argv, game);
 	check_scene(json, game);
+	check_render(json, game);
 	json.objects = cJSON_GetObjectItemCaseSensitive(json.json, "objects");
 	json.object = (json.objects != NULL) ? (json.objects)->child : NULL;
 	while (json.object)
@@ -54,12 +72,14 @@ void			read_scene(char *argv, t_game *game)
 	game->textures = (t_txture*)malloc_exit(sizeof(t_txture) *
 	game->textures_num);
 	while (++id < game->textures_num)
-		get_texture(game->texture_list[id], &(game->textures[id]), \
+		get_texture(game, game->texture_list[id], &(game->textures[id]), \
 		"./textures/");
 	game->normals = (t_txture*)malloc_exit(sizeof(t_txture) *
 	game->normals_num);
 	id = -1;
 	while (++id < game->normals_num)
-		get_texture(game->normal_list[id], &(game->normals[id]), "./normals/");
+		get_texture(game, game->normal_list[id], &(game->normals[id]),
+		"./normals/");
+	build_bvh(game);
 	cJSON_Delete(json.json);
 }